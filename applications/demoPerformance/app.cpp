@@ -14,6 +14,77 @@
 	#define PERFORMANCE_TEST_SECONDS	5
 #endif
 
+/* Optional benchmarks before rendering: */
+#if 0
+	#define LSYS_BENCHMARK
+	#define LSYS_BENCHMARK_RUNS			10			// value between 1 and 255
+#endif
+
+/* Optional benchmark of the fused pipeline (LSysStream => PlantTurtle) against generate-then-interpret (median of runs): */
+#if 0
+	#define LSYS_PIPELINE_BENCHMARK
+	#define LSYS_PIPELINE_BENCHMARK_RUNS	10			// value between 1 and 255
+#endif
+
+/* Optional benchmark of VertexKernel against the glm vertex transform (median of runs): */
+#if 0
+	#define VERTEX_KERNEL_BENCHMARK
+	#define VERTEX_KERNEL_BENCHMARK_VERTICES	1000000
+	#define VERTEX_KERNEL_BENCHMARK_RUNS		20			// value between 1 and 255
+#endif
+
+/* Optional benchmark of the wind animation per complexity => former AoS path vs BoneKernel: */
+#if 0
+	#define BONE_KERNEL_BENCHMARK
+	#define BONE_KERNEL_BENCHMARK_MIN_COMPLEXITY	4
+	#define BONE_KERNEL_BENCHMARK_MAX_COMPLEXITY	10
+	#define BONE_KERNEL_BENCHMARK_MAX_BONES			(1 << 22)	// larger complexities are skipped
+	#define BONE_KERNEL_BENCHMARK_RUNS				20			// value between 1 and 255
+#endif
+
+/* Optional instanced LSysObject => source primitives are stored once and drawn per PrimitiveInstance: */
+#if 0
+	#define LSYS_INSTANCING
+#endif
+
+/* Optional branch parallel interpretation of the packed word => same LSysObject as the sequential turtle: */
+#if 0
+	#define LSYS_BRANCH_PARALLEL
+#endif
+
+/* Optional parametric plant instead of the word of LSysGenerator: */
+#if 0
+	#define LSYS_PARAMETRIC
+#endif
+
+/* Optional LOD chain => distant objects are drawn without their deepest branches: */
+#if 0
+	#define LSYS_LOD
+	#define LSYS_LOD_LEVELS				4			// value between 1 and 255
+#endif
+
+/* Optional quantized vertices => CompactVertex (20 instead of 40 bytes) is decoded per draw call by the vertex shaders: */
+#if 0
+	#define LSYS_COMPACT_VERTICES
+#endif
+
+/* Optional interactive rebuild => Up/Down steps --c= while rendering and only the rewritten ranges are uploaded again (ignored by LSYS_PARAMETRIC): */
+#if 0
+	#define LSYS_INTERACTIVE_REBUILD
+	#define LSYS_INTERACTIVE_MAX_COMPLEXITY	10			// value between 0 and 255
+#endif
+
+/* Optional compact bone palette => 3x4 affine (48 instead of 64 bytes) or dual quaternion (32 instead of 64 bytes) per bone: */
+#if 0
+	#define LSYS_BONE_FORMAT			pje::engine::types::LSysObject::BoneFormat::DualQuaternion
+#endif
+
+/* Optional benchmark of the bone palette formats => upload bytes, packing and a CPU replica of the skinning (median of runs): */
+#if 0
+	#define BONE_FORMAT_BENCHMARK
+	#define BONE_FORMAT_BENCHMARK_RUNS	20			// value between 1 and 255
+#endif
+
 /* ######################################################################## */
 
 int main(int argc, char* argv[]) {
@@ -23,6 +94,7 @@ int main(int argc, char* argv[]) {
 	/* API-unspecific variables */
 	std::unique_ptr<pje::engine::ArgsParser>	parser;
 	std::unique_ptr<pje::engine::LSysGenerator>	generator;
+	std::unique_ptr<pje::engine::LSysDag>		lSysDag;
 	std::unique_ptr<pje::engine::Sourceloader>	loader;
 	std::unique_ptr<pje::engine::PlantTurtle>	plantTurtle;
 	/* API-specific variables */
@@ -37,30 +109,105 @@ int main(int argc, char* argv[]) {
 		return -1;
 	}
 
-	/* L-System Word Generator */
+	/* Primitive Loader */
 	try {
-		generator = std::make_unique<pje::engine::LSysGenerator>(
-			std::string("SLF-+[]"),							// Alphabet
-			"S",											// Axiom
-			std::unordered_map<std::string, std::string> {	// Rules
-				{"]S","S[-S]S[+L]S"}, {"SS","S"}, 
-				{"-S","SS[-L]+L"}, {"+S","S[-L]S"}, 
-				{"-L","F"}, {"+L","S[-L]+L"}
-			}, 
-			parser->m_complexityOfObjects,					// Iterations
-			"]"												// Environmental Input
-		);
-
-		std::cout << "[PJE] \tL-System word: " << generator->getCurrentLSysWord() << "\n" << std::endl;
+		loader = std::make_unique<pje::engine::Sourceloader>();
 	}
 	catch (std::runtime_error& ex) {
 		std::cout << "[ERROR] Exception thrown: " << ex.what() << std::endl;
 		return -1;
 	}
+#if defined(VERTEX_KERNEL_BENCHMARK)
+	benchmarkVertexKernel(loader->m_primitives[0], VERTEX_KERNEL_BENCHMARK_VERTICES, VERTEX_KERNEL_BENCHMARK_RUNS);
+#endif
 
-	/* Primitive Loader */
+	/* L-System Word Generator */
 	try {
-		loader = std::make_unique<pje::engine::Sourceloader>();
+		pje::engine::LSysGenerator::DerivationMode derivationMode = pje::engine::LSysGenerator::DerivationMode::Parallel;
+		if (parser->m_derivation == "sequential")
+			derivationMode = pje::engine::LSysGenerator::DerivationMode::Sequential;
+		else if (parser->m_derivation == "streaming")
+			derivationMode = pje::engine::LSysGenerator::DerivationMode::Streaming;
+		else if (parser->m_derivation == "dag")
+			derivationMode = pje::engine::LSysGenerator::DerivationMode::Dag;
+		else if (parser->m_derivation != "parallel")
+			throw std::runtime_error("Unknown derivation mode --derive=" + parser->m_derivation + " | valid modes: sequential, parallel, streaming, dag");
+
+		const std::string									lSysAlphabet	= "SLF-+[]";
+		const std::string									lSysAxiom		= "S";
+		std::unordered_map<std::string, std::vector<pje::engine::LSysProduction>> lSysRules = {
+			{"]S", {{"S[-S]S[+L]S", 1.0f}}}, {"SS", {{"S", 1.0f}}}, 
+			{"-S", {{"SS[-L]+L", 1.0f}}}, {"+S", {{"S[-L]S", 1.0f}}}, 
+			{"-L", {{"F", 1.0f}}}, {"+L", {{"S[-L]+L", 1.0f}}}
+		};
+		const std::string									lSysEnvInput	= "]";
+
+		/* weighted alternatives for --seed=<n> => every seed grows another plant */
+		if (parser->m_seed != 0) {
+			lSysRules["-S"].push_back({ "S[+L]S", 0.5f });
+			lSysRules["+L"].push_back({ "S[+L]-L", 0.5f });
+		}
+
+		plantTurtle = std::make_unique<pje::engine::PlantTurtle>(lSysAlphabet);
+#if defined(LSYS_INSTANCING)
+		plantTurtle->setBuildMode(pje::engine::PlantTurtle::BuildMode::Instances);
+#endif
+#if defined(LSYS_BRANCH_PARALLEL)
+		plantTurtle->setInterpretation(pje::engine::PlantTurtle::Interpretation::BranchParallel);
+#endif
+
+		/* memory budget: predicts word and LSysObject before anything is generated */
+		{
+			pje::engine::LSysGenerator predictor(lSysAlphabet, lSysAxiom, lSysRules, 0, lSysEnvInput, pje::engine::LSysGenerator::DerivationMode::Streaming, parser->m_seed);
+			bool storesWord = derivationMode == pje::engine::LSysGenerator::DerivationMode::Sequential || derivationMode == pje::engine::LSysGenerator::DerivationMode::Parallel;
+
+			parser->m_complexityOfObjects = admitLSysComplexity(
+				predictor, *plantTurtle, loader->m_registry, parser->m_complexityOfObjects, static_cast<uint64_t>(parser->m_memoryBudget) << 20, storesWord
+			);
+			plantTurtle->reserveLSysObject(
+				plantTurtle->predictLSysObject(predictor.predictWord(parser->m_complexityOfObjects), loader->m_registry)
+			);
+		}
+
+		/* derived words of prior launches */
+		std::unique_ptr<pje::engine::LSysCache> lSysCache;
+		if (!parser->m_cacheDirectory.empty())
+			lSysCache = std::make_unique<pje::engine::LSysCache>(parser->m_cacheDirectory);
+
+		generator = std::make_unique<pje::engine::LSysGenerator>(
+			lSysAlphabet,									// Alphabet
+			lSysAxiom,										// Axiom
+			lSysRules,										// Rules
+			parser->m_complexityOfObjects,					// Iterations
+			lSysEnvInput,									// Environmental Input
+			derivationMode,
+			parser->m_seed,									// Seed for weighted alternatives
+			lSysCache.get()									// Cache of derived words
+		);
+
+		/* streamed and shared words are never stored */
+		if (derivationMode == pje::engine::LSysGenerator::DerivationMode::Dag) {
+			lSysDag = std::make_unique<pje::engine::LSysDag>(*generator);
+			std::cout << "[PJE] \tL-System word statistics (" << lSysDag->getNodeCount() << " shared nodes):";
+			for (const auto& symbol : generator->getAlphabet())
+				std::cout << " " << symbol << " = " << lSysDag->getSymbolCount(symbol) << " |";
+			std::cout << "\n" << std::endl;
+		}
+		else if (derivationMode != pje::engine::LSysGenerator::DerivationMode::Streaming) {
+			std::cout << "[PJE] \tL-System word: " << generator->getCurrentLSysWord() << "\n" << std::endl;
+		}
+#if defined(LSYS_BENCHMARK)
+		benchmarkLSysGenerator(*generator, parser->m_complexityOfObjects, LSYS_BENCHMARK_RUNS);
+#endif
+#if defined(LSYS_PIPELINE_BENCHMARK)
+		benchmarkLSysPipeline(*generator, loader->m_registry, parser->m_complexityOfObjects, LSYS_PIPELINE_BENCHMARK_RUNS);
+#endif
+#if defined(BONE_KERNEL_BENCHMARK)
+		benchmarkBoneKernel(
+			*generator, *plantTurtle, loader->m_registry, 
+			BONE_KERNEL_BENCHMARK_MIN_COMPLEXITY, BONE_KERNEL_BENCHMARK_MAX_COMPLEXITY, BONE_KERNEL_BENCHMARK_MAX_BONES, BONE_KERNEL_BENCHMARK_RUNS
+		);
+#endif
 	}
 	catch (std::runtime_error& ex) {
 		std::cout << "[ERROR] Exception thrown: " << ex.what() << std::endl;
@@ -69,11 +216,50 @@ int main(int argc, char* argv[]) {
 
 	/* Creating LSysObject (Renderable) */
 	try {
-		plantTurtle = std::make_unique<pje::engine::PlantTurtle>(
-			std::string(generator->getAlphabet())
+#if defined(LSYS_PARAMETRIC)
+		/* stems shrink per iteration | leaves grow until they blossom */
+		pje::engine::LSysParametricGenerator parametricGenerator(
+			"SLF-+[]",
+			"S(0.2)",
+			{
+				{"S(l)", "l > 0.02",	"S(l*0.8)[-(30)S(l*0.6)]S(l*0.8)[+(25)L(0.5)]"},
+				{"L(s)", "s < 1",		"L(s+0.25)"},
+				{"L(s)", "s >= 1",		"F(s*0.8)"}
+			},
+			parser->m_complexityOfObjects,
+			"]"
 		);
-
-		plantTurtle->buildLSysObject(generator->getCurrentLSysWord(), loader->m_primitives);
+		std::cout << "[PJE] \tParametric L-System modules: " << parametricGenerator.getCurrentWord().modules.size() << "\n" << std::endl;
+		plantTurtle->buildLSysObject(parametricGenerator.getCurrentWord(), loader->m_registry);
+#else
+		if (generator->getDerivationMode() == pje::engine::LSysGenerator::DerivationMode::Streaming) {
+			pje::engine::LSysStream lSysStream = generator->getStream();
+			plantTurtle->buildLSysObject(lSysStream, loader->m_registry);
+		}
+		else if (generator->getDerivationMode() == pje::engine::LSysGenerator::DerivationMode::Dag) {
+			plantTurtle->buildLSysObject(*lSysDag, loader->m_registry);
+		}
+		else {
+#if defined(LSYS_INTERACTIVE_REBUILD)
+			/* word is kept by plantTurtle => first step of --c= is rebuilt from it */
+			plantTurtle->rebuildLSysObject(generator->getPackedLSysWord(), loader->m_registry);
+#else
+			plantTurtle->buildLSysObject(generator->getPackedLSysWord(), loader->m_registry);
+#endif
+		}
+#endif
+#if defined(LSYS_LOD)
+		plantTurtle->buildLodChain(LSYS_LOD_LEVELS);
+#endif
+#if defined(LSYS_COMPACT_VERTICES)
+		plantTurtle->m_renderable.compactVertices();
+#endif
+#if defined(BONE_FORMAT_BENCHMARK)
+		benchmarkBoneFormats(plantTurtle->m_renderable, BONE_FORMAT_BENCHMARK_RUNS);
+#endif
+#if defined(LSYS_BONE_FORMAT)
+		plantTurtle->m_renderable.setBoneFormat(LSYS_BONE_FORMAT);
+#endif
 	}
 	catch (std::runtime_error& ex) {
 		std::cout << "[ERROR] Exception thrown: " << ex.what() << std::endl;
@@ -139,6 +325,11 @@ int main(int argc, char* argv[]) {
 	std::chrono::milliseconds	deltaTime;
 	size_t						amountOfRenderedFrames = 0;
 #endif
+#if defined(LSYS_INTERACTIVE_REBUILD) && !defined(LSYS_PARAMETRIC)
+	pje::engine::types::LSysObjectPatch	lSysPatch = {};		// ranges of the latest stepLSysComplexity()
+#endif
+	std::vector<size_t>			visiblePerFrame;	// frustum culling: deployed primitives (instanced: instances) drawn per frame
+	std::vector<size_t>			culledPerFrame;
 
 	/* Scene preparation - Start */
 	auto startTime = std::chrono::steady_clock::now();
@@ -157,12 +348,17 @@ int main(int argc, char* argv[]) {
 			vkRenderer->uploadBuffer(plantTurtle->m_renderable, vkRenderer->m_buffUniformMVP, pje::renderer::RendererVK::BufferType::UniformMVP);
 			vkRenderer->uploadBuffer(plantTurtle->m_renderable, vkRenderer->m_buffStorageBoneRefs, pje::renderer::RendererVK::BufferType::StorageBoneRefs);
 			vkRenderer->uploadBuffer(plantTurtle->m_renderable, vkRenderer->m_buffStorageBones, pje::renderer::RendererVK::BufferType::StorageBones);
+			plantTurtle->m_renderable.clearDirtyBones();
+			if (plantTurtle->m_renderable.isInstanced())
+				vkRenderer->uploadBuffer(plantTurtle->m_renderable, vkRenderer->m_buffStorageInstances, pje::renderer::RendererVK::BufferType::StorageInstances);
 
 			/* Binding shader resources - ONCE to descriptor set */
 			vkRenderer->bindToShader(vkRenderer->m_buffUniformMVP, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
 			vkRenderer->bindToShader(vkRenderer->m_buffStorageBoneRefs, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
 			vkRenderer->bindToShader(vkRenderer->m_buffStorageBones, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
 			vkRenderer->bindToShader(vkRenderer->m_texAlbedo, 3, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+			if (plantTurtle->m_renderable.isInstanced())
+				vkRenderer->bindToShader(vkRenderer->m_buffStorageInstances, 4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
 
 			std::cout << 
 				"[PJE] \tVulkan setup time: " << 
@@ -174,6 +370,11 @@ int main(int argc, char* argv[]) {
 			auto startRenderingTime = std::chrono::steady_clock::now();
 			while (!glfwWindowShouldClose(window)) {
 
+#if defined(LSYS_INTERACTIVE_REBUILD) && !defined(LSYS_PARAMETRIC)
+				/* Rebuilding renderable => only its rewritten ranges are uploaded | before animation: palette of the new build is at restpose */
+				if (stepLSysComplexity(window, *generator, *plantTurtle, loader->m_registry, parser->m_complexityOfObjects, LSYS_INTERACTIVE_MAX_COMPLEXITY, lSysPatch))
+					vkRenderer->updateRenderable(plantTurtle->m_renderable, lSysPatch);
+#endif
 #if defined(QUANTITY_TEST)
 				if (warmupFrameCount == WARMUP_FRAMES) {
 					plantTurtle->m_renderable.animWindBlow(deltaFrame * 1e-3, 0.5f);
@@ -186,6 +387,7 @@ int main(int argc, char* argv[]) {
 #endif
 				/* Updating shader resources */
 				vkRenderer->updateBuffer(plantTurtle->m_renderable, vkRenderer->m_buffStorageBones, pje::renderer::RendererVK::BufferType::StorageBones);
+				plantTurtle->m_renderable.clearDirtyBones();
 				vkRenderer->updateBuffer(plantTurtle->m_renderable, vkRenderer->m_buffUniformMVP, pje::renderer::RendererVK::BufferType::UniformMVP);
 
 #if defined(QUANTITY_TEST)
@@ -193,6 +395,8 @@ int main(int argc, char* argv[]) {
 #endif
 				/* Rendering */
 				vkRenderer->renderIn(window, plantTurtle->m_renderable);
+				visiblePerFrame.push_back(vkRenderer->getCullStats().visible);
+				culledPerFrame.push_back(vkRenderer->getCullStats().culled);
 #if defined(TIME_TEST)
 				++amountOfRenderedFrames;
 #endif
@@ -232,6 +436,9 @@ int main(int argc, char* argv[]) {
 			glRenderer->uploadBuffer(plantTurtle->m_renderable, pje::renderer::RendererGL::BufferType::UniformMVP);
 			glRenderer->uploadBuffer(plantTurtle->m_renderable, pje::renderer::RendererGL::BufferType::StorageBoneRefs);
 			glRenderer->uploadBuffer(plantTurtle->m_renderable, pje::renderer::RendererGL::BufferType::StorageBones);
+			plantTurtle->m_renderable.clearDirtyBones();
+			if (plantTurtle->m_renderable.isInstanced())
+				glRenderer->uploadBuffer(plantTurtle->m_renderable, pje::renderer::RendererGL::BufferType::StorageInstances);
 
 			/* Binding shader resources */
 			glRenderer->bindRenderable(plantTurtle->m_renderable);
@@ -246,6 +453,11 @@ int main(int argc, char* argv[]) {
 			auto startRenderingTime = std::chrono::steady_clock::now();
 			while (!glfwWindowShouldClose(window)) {
 
+#if defined(LSYS_INTERACTIVE_REBUILD) && !defined(LSYS_PARAMETRIC)
+				/* Rebuilding renderable => only its rewritten ranges are uploaded | before animation: palette of the new build is at restpose */
+				if (stepLSysComplexity(window, *generator, *plantTurtle, loader->m_registry, parser->m_complexityOfObjects, LSYS_INTERACTIVE_MAX_COMPLEXITY, lSysPatch))
+					glRenderer->updateRenderable(plantTurtle->m_renderable, lSysPatch);
+#endif
 #if defined(QUANTITY_TEST)
 				if (warmupFrameCount == WARMUP_FRAMES) {
 					plantTurtle->m_renderable.animWindBlow(deltaFrame * 1e-3, 0.5f);
@@ -258,6 +470,7 @@ int main(int argc, char* argv[]) {
 #endif
 				/* Updating shader resources */
 				glRenderer->updateBuffer(plantTurtle->m_renderable, pje::renderer::RendererGL::BufferType::StorageBones);
+				plantTurtle->m_renderable.clearDirtyBones();
 				glRenderer->updateBuffer(plantTurtle->m_renderable, pje::renderer::RendererGL::BufferType::UniformMVP);
 
 #if defined(QUANTITY_TEST)
@@ -265,6 +478,8 @@ int main(int argc, char* argv[]) {
 #endif
 				/* Rendering */
 				glRenderer->renderIn(window, plantTurtle->m_renderable);
+				visiblePerFrame.push_back(glRenderer->getCullStats().visible);
+				culledPerFrame.push_back(glRenderer->getCullStats().culled);
 #if defined(TIME_TEST)
 				++amountOfRenderedFrames;
 #endif
@@ -320,6 +535,15 @@ int main(int argc, char* argv[]) {
 #elif defined(TIME_TEST)
 	std::cout << "[PJE] \tFrames rendered: " << amountOfRenderedFrames << std::endl;
 #endif
+	if (!visiblePerFrame.empty()) {
+		std::cout <<
+			"[PJE] \tFrustum culling per frame (primitives | instanced: instances):\n\tvisible min (" <<
+			*std::min_element(visiblePerFrame.begin(), visiblePerFrame.end()) << ") | max (" << *std::max_element(visiblePerFrame.begin(), visiblePerFrame.end()) << 
+			") | median (" << getMedian(visiblePerFrame) << ")\n\tculled min (" <<
+			*std::min_element(culledPerFrame.begin(), culledPerFrame.end()) << ") | max (" << *std::max_element(culledPerFrame.begin(), culledPerFrame.end()) << 
+			") | median (" << getMedian(culledPerFrame) << ")" <<
+		std::endl;
+	}
 
 	/* Terminating application */
 	glfwTerminate();
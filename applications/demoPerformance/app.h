@@ -28,7 +28,11 @@
 	#include "engine/pjeBuffers.h"
 	#include "engine/argsParser.h"
 	#include "engine/lSysGenerator.h"
+	#include "engine/lSysParametric.h"
+	#include "engine/lSysCache.h"
 	#include "engine/sourceloader.h"
+	#include "engine/vertexKernel.h"
+	#include "engine/boneKernel.h"
 	#include "engine/turtleInterpreter.h"
 	#include "opengl/rendererGL.h"
 	#include "vulkan/rendererVK.h"
@@ -56,4 +60,447 @@ double getStandardDeviation(std::vector<size_t> dataset, double mean) {
 		sd += pow(element - mean, 2);
 	}
 	return sqrt(sd / dataset.size());
-}
\ No newline at end of file
+}
+
+/* highest complexity <= requested whose predicted word and LSysObject fit into budgetBytes (0 => unlimited) */
+uint8_t admitLSysComplexity(
+	const pje::engine::LSysGenerator& generator, 
+	const pje::engine::PlantTurtle& turtle, 
+	const pje::engine::types::PrimitiveRegistry& primitives, 
+	uint8_t requested, 
+	uint64_t budgetBytes, 
+	bool storesWord
+) {
+	if (budgetBytes == 0)
+		return requested;
+
+	for (int complexity = requested; complexity >= 0; complexity--) {
+		auto wordPrediction		= generator.predictWord(static_cast<uint8_t>(complexity));
+		auto objectPrediction	= turtle.predictLSysObject(wordPrediction, primitives);
+
+		/* ping-pong buffers of LSysGenerator hold the last two words */
+		uint64_t bytes = objectPrediction.bytes;
+		if (storesWord) {
+			bytes += pje::engine::PackedWord::byteSizeOf(wordPrediction.length, generator.getAlphabet().size());
+			if (complexity > 0)
+				bytes += pje::engine::PackedWord::byteSizeOf(generator.predictWord(static_cast<uint8_t>(complexity - 1)).length, generator.getAlphabet().size());
+		}
+
+		std::cout << 
+			"[PJE] \tPrediction for --c=" << complexity << " : " << wordPrediction.length << " symbols | " << 
+			objectPrediction.primitives << " primitives | " << objectPrediction.instances << " instances | " << objectPrediction.bones << " bones | " << objectPrediction.boneRefs << " boneRefs | " << 
+			objectPrediction.vertices << " vertices | " << objectPrediction.indices << " indices | " << (bytes >> 20) << " MiB\n";
+
+		if (bytes <= budgetBytes) {
+			if (complexity != requested)
+				std::cout << "[PJE] \tComplexity was downgraded from " << static_cast<int>(requested) << " to " << complexity << " by the memory budget.\n";
+			std::cout << std::endl;
+			return static_cast<uint8_t>(complexity);
+		}
+	}
+
+	throw std::runtime_error("LSysObject exceeds the memory budget even without any iteration.");
+}
+
+/* Up/Down (once per key press) => complexity +-1 within [0, maxComplexity] | derives the new word and rebuilds m_renderable of turtle from the prior one
+*	>> [INFO]	m_matrices, LSysLods and CompactVertices of m_renderable are restored after the rebuild => renderers keep their setup
+*	>> [INFO]	returns true if patch holds the rewritten ranges => updateRenderable() of the renderer
+*/
+bool stepLSysComplexity(
+	GLFWwindow* window, 
+	pje::engine::LSysGenerator& generator, 
+	pje::engine::PlantTurtle& turtle, 
+	const pje::engine::types::PrimitiveRegistry& primitives, 
+	uint8_t& complexity, 
+	uint8_t maxComplexity, 
+	pje::engine::types::LSysObjectPatch& patch
+) {
+	/* key of the latest call => holding a key steps once */
+	static int heldKey = GLFW_KEY_UNKNOWN;
+
+	int key = GLFW_KEY_UNKNOWN;
+	if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+		key = GLFW_KEY_UP;
+	else if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
+		key = GLFW_KEY_DOWN;
+
+	if (key == heldKey)
+		return false;
+	heldKey = key;
+
+	const int next = complexity + (key == GLFW_KEY_UP ? 1 : -1);
+	if (key == GLFW_KEY_UNKNOWN || next < 0 || next > maxComplexity)
+		return false;
+	complexity = static_cast<uint8_t>(next);
+
+	auto& renderable = turtle.m_renderable;
+
+	/* scene state and derived data of the current build => rebuilt or restored afterwards */
+	const pje::engine::types::MVPMatrices	matrices	= renderable.m_matrices;
+	const uint32_t							lodLevels	= static_cast<uint32_t>(renderable.m_lods.size());
+	const bool								compact		= renderable.isCompact();
+
+	generator.generate1LSysWord(generator.getAxiom(), complexity);
+	patch = turtle.rebuildLSysObject(generator.getPackedLSysWord(), primitives);
+
+	renderable.m_matrices = matrices;
+	if (lodLevels > 0)
+		turtle.buildLodChain(lodLevels);
+	if (compact)
+		renderable.compactVertices();
+
+	std::cout << 
+		"[PJE] \tComplexity stepped to --c=" << static_cast<int>(complexity) << (patch.complete ? " (full build)" : "") << " => patched " << 
+		patch.vertices.count << " of " << renderable.m_vertices.size() << " vertices | " << 
+		patch.indices.count << " of " << renderable.m_indices.size() << " indices\n" << 
+	std::endl;
+
+	return true;
+}
+
+/* Rewrites the 1L-System of generator multiple times and prints median symbols/second per iteration */
+void benchmarkLSysGenerator(pje::engine::LSysGenerator& generator, uint8_t iterations, uint8_t runs) {
+	std::vector<std::vector<size_t>> durations(iterations);
+	std::vector<size_t> symbols(iterations);
+
+	for (uint8_t run = 0; run < runs; run++) {
+		generator.generate1LSysWord(generator.getAxiom(), iterations);
+
+		for (uint8_t i = 0; i < iterations; i++) {
+			durations[i].push_back(generator.getIterationStats()[i].nanoseconds);
+			symbols[i] = generator.getIterationStats()[i].symbols;
+		}
+	}
+
+	std::cout << "[PJE] \tL-System benchmark (median of " << static_cast<int>(runs) << " runs):\n";
+	for (uint8_t i = 0; i < iterations; i++) {
+		double median = getMedian(durations[i]);
+		std::cout <<
+			"\tIteration " << i + 1 << " : \t" << symbols[i] << " symbols | " <<
+			median * 1e-3 << "us | " << symbols[i] / (median * 1e-9) << " symbols/s\n";
+	}
+	std::cout << std::endl;
+}
+
+/* Derives and interprets the word of generator per iteration: generate-then-interpret (stored PackedWord) vs fused (LSysStream => PlantTurtle) => median symbols/s | prediction of the fused path is timed on its own */
+void benchmarkLSysPipeline(const pje::engine::LSysGenerator& generator, const pje::engine::types::PrimitiveRegistry& primitives, uint8_t iterations, uint8_t runs) {
+	pje::engine::LSysGenerator	derivation(generator);		// copy => word of generator stays untouched
+	pje::engine::PlantTurtle	turtle(generator.getAlphabet());
+
+	auto measure = [runs](const auto& pipeline) {
+		std::vector<size_t> durations;
+		for (uint8_t run = 0; run < runs; run++) {
+			auto start = std::chrono::steady_clock::now();
+			pipeline();
+			durations.push_back(static_cast<size_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+		}
+		return getMedian(durations);
+	};
+
+	std::cout << "[PJE] \tL-System pipeline benchmark (median of " << static_cast<int>(runs) << " runs):\n";
+	for (uint8_t i = 1; i <= iterations; i++) {
+		const uint64_t symbols = derivation.predictWord(i).length;
+
+		/* prediction := setup of the fused path only (stored path counts its word inside of buildLSysObject()) => reported on its own */
+		pje::engine::PlantTurtle::BuildPrediction prediction = {};
+		double predict = measure([&]() {
+			prediction = turtle.predictLSysObject(derivation.predictWord(i), primitives);
+		});
+
+		/* build summaries of PlantTurtle are muted while measuring => restored before any exception reaches the caller */
+		std::streambuf* console = std::cout.rdbuf(nullptr);
+		double stored	= 0.0;
+		double fused	= 0.0;
+		size_t wordBytes = 0;
+		try {
+			/* word is derived and stored first => interpreted afterwards */
+			stored = measure([&]() {
+				derivation.generate1LSysWord(derivation.getAxiom(), i);
+				turtle.buildLSysObject(derivation.getPackedLSysWord(), primitives);
+			});
+			wordBytes = derivation.getPackedLSysWord().byteSize();
+
+			/* word is derived while it is interpreted => m_renderable is sized by the prediction above */
+			fused = measure([&]() {
+				turtle.reserveLSysObject(prediction);
+				pje::engine::LSysStream stream(derivation, derivation.getAxiom(), i);
+				turtle.buildLSysObject(stream, primitives);
+			});
+		}
+		catch (...) {
+			std::cout.rdbuf(console);
+			throw;
+		}
+		std::cout.rdbuf(console);
+
+		std::cout <<
+			"\tIteration " << static_cast<int>(i) << " : \t" << symbols << " symbols\n" <<
+			"\t\tgenerate-then-interpret : \t" << stored * 1e-3 << "us | " << symbols / (stored * 1e-9) << " symbols/s | word " << wordBytes << " bytes\n" <<
+			"\t\tfused : \t\t\t" << fused * 1e-3 << "us | " << symbols / (fused * 1e-9) << " symbols/s | " << static_cast<int>(i) + 1 << " stream frames\n" <<
+			"\t\tprediction (fused setup) : \t" << predict * 1e-3 << "us\n";
+	}
+	std::cout << std::endl;
+}
+
+/* Transforms vertices of primitive (repeated up to count) via the former glm path and via VertexKernel => median vertices/s per instruction set */
+void benchmarkVertexKernel(const pje::engine::types::Primitive& primitive, size_t count, uint8_t runs) {
+	std::vector<pje::engine::types::Vertex> source;
+	source.reserve(count);
+	while (source.size() < count) {
+		for (const auto& mesh : primitive.m_meshes)
+			for (const auto& vertex : mesh.m_vertices)
+				if (source.size() < count)
+					source.push_back(vertex);
+	}
+
+	std::vector<pje::engine::types::Vertex> reference(source);
+	std::vector<pje::engine::types::Vertex> result(source);
+	const glm::mat4 modelMat	= glm::rotate(glm::translate(glm::mat4(1.0f), glm::vec3(0.3f, 1.2f, -0.5f)), glm::radians(30.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+	const glm::uvec2 boneAttrib	= glm::uvec2(7, 1);
+
+	auto measure = [runs](const auto& transform) {
+		std::vector<size_t> durations;
+		for (uint8_t run = 0; run < runs; run++) {
+			auto start = std::chrono::steady_clock::now();
+			transform();
+			durations.push_back(static_cast<size_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+		}
+		return getMedian(durations);
+	};
+
+	std::cout << "[PJE] \tVertexKernel benchmark (" << count << " vertices, median of " << static_cast<int>(runs) << " runs):\n";
+
+	/* former path of deployPrimitive: normal matrix per vertex */
+	double median = measure([&]() {
+		std::transform(
+			std::execution::par_unseq,
+			source.begin(),
+			source.end(),
+			reference.begin(),
+			[&](const pje::engine::types::Vertex& v) {
+				return pje::engine::types::Vertex(
+					glm::vec3(modelMat * glm::vec4(v.m_pos, 1.0f)),
+					glm::normalize(glm::transpose(glm::inverse(modelMat)) * glm::vec4(v.m_normal, 0.0f)),
+					v.m_uv,
+					boneAttrib
+				);
+			}
+		);
+	});
+	std::cout << "\tglm par_unseq : \t" << median * 1e-3 << "us | " << count / (median * 1e-9) << " vertices/s\n";
+
+	for (auto isa : { pje::engine::VertexKernel::Isa::Scalar, pje::engine::VertexKernel::Isa::SSE, pje::engine::VertexKernel::Isa::AVX2 }) {
+		if (!pje::engine::VertexKernel::supports(isa))
+			continue;
+
+		median = measure([&]() {
+			pje::engine::VertexKernel::transform(source.data(), result.data(), count, modelMat, boneAttrib, isa);
+		});
+
+		/* positions must match the glm path */
+		float maxError = 0.0f;
+		for (size_t i = 0; i < count; i++)
+			maxError = std::max(maxError, glm::length(result[i].m_pos - reference[i].m_pos));
+
+		std::cout << 
+			"\tVertexKernel " << pje::engine::VertexKernel::nameOf(isa) << " : \t" << median * 1e-3 << "us | " << 
+			count / (median * 1e-9) << " vertices/s | max position error " << maxError << "\n";
+	}
+	std::cout << std::endl;
+}
+
+/* Animates the predicted bone count per complexity via the former AoS path (animWindBlow + getBoneMatrices) and via BoneKernel => median bones/s per instruction set */
+void benchmarkBoneKernel(
+	const pje::engine::LSysGenerator& generator, 
+	const pje::engine::PlantTurtle& turtle, 
+	const pje::engine::types::PrimitiveRegistry& primitives, 
+	uint8_t minComplexity, 
+	uint8_t maxComplexity, 
+	uint64_t maxBones, 
+	uint8_t runs
+) {
+	const float tilt = 0.3f;
+
+	auto measure = [runs](const auto& animate) {
+		std::vector<size_t> durations;
+		for (uint8_t run = 0; run < runs; run++) {
+			auto start = std::chrono::steady_clock::now();
+			animate();
+			durations.push_back(static_cast<size_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+		}
+		return getMedian(durations);
+	};
+
+	std::cout << "[PJE] \tBoneKernel benchmark (median of " << static_cast<int>(runs) << " runs):\n";
+	for (int complexity = minComplexity; complexity <= maxComplexity; complexity++) {
+		const uint64_t count = turtle.predictLSysObject(generator.predictWord(static_cast<uint8_t>(complexity)), primitives).bones;
+		if (count == 0 || count > maxBones) {
+			std::cout << "\tComplexity " << complexity << " : \t" << count << " bones => skipped\n";
+			continue;
+		}
+
+		/* restposes of arbitrary orientation => same cost as the bones of a plant */
+		std::vector<pje::engine::types::Bone> bones(count);
+		for (size_t i = 0; i < count; i++) {
+			pje::engine::types::RigidTransform restpose;
+			restpose.rotation		= glm::normalize(glm::quat(std::cos(i * 0.1f), std::sin(i * 0.3f), std::cos(i * 0.7f), std::sin(i * 1.1f)));
+			restpose.translation	= glm::vec3(std::sin(i * 0.01f), i * 1e-4f, std::cos(i * 0.02f));
+			bones[i] = pje::engine::types::Bone{ restpose, restpose.toMat4() };
+		}
+		pje::engine::types::BoneRestFrames frames;
+		frames.assign(bones);
+		std::vector<pje::engine::types::BoneMatrix> palette(count);
+
+		/* former path: animationpose per bone => palette allocated and multiplied per call */
+		std::vector<glm::mat4> reference;
+		double median = measure([&]() {
+			const glm::mat4 tiltMat = glm::rotate(glm::mat4(1.0f), tilt, glm::vec3(0.0f, 0.0f, 1.0f));
+			for (auto& bone : bones)
+				bone.animationpose = bone.restpose.toMat4() * tiltMat;
+
+			std::vector<glm::mat4> res;
+			for (const auto& bone : bones)
+				res.push_back(bone.animationpose * bone.restpose.inverse().toMat4());
+			reference.swap(res);
+		});
+		std::cout << "\tComplexity " << complexity << " : \t" << count << " bones\n";
+		std::cout << "\t\tAoS glm : \t\t" << median * 1e-3 << "us | " << count / (median * 1e-9) << " bones/s\n";
+
+		for (auto isa : { pje::engine::BoneKernel::Isa::Scalar, pje::engine::BoneKernel::Isa::SSE, pje::engine::BoneKernel::Isa::AVX2 }) {
+			if (!pje::engine::VertexKernel::supports(isa))
+				continue;
+
+			for (bool parallel : { false, true }) {
+				/* below parallelThreshold both paths are identical */
+				if (parallel && count < pje::engine::BoneKernel::parallelThreshold)
+					continue;
+
+				median = measure([&]() {
+					pje::engine::BoneKernel::windPalette(frames, palette.data(), tilt, isa, parallel);
+				});
+
+				/* palette must match the former path */
+				float maxError = 0.0f;
+				for (size_t i = 0; i < count; i++)
+					for (int column = 0; column < 4; column++)
+						maxError = std::max(maxError, glm::length(palette[i].matrix[column] - reference[i][column]));
+
+				std::cout << 
+					"\t\tBoneKernel " << pje::engine::VertexKernel::nameOf(isa) << (parallel ? " par" : "") << " : \t" << median * 1e-3 << "us | " << 
+					count / (median * 1e-9) << " bones/s | max error " << maxError << "\n";
+			}
+		}
+	}
+	std::cout << std::endl;
+}
+
+/* Packs the wind palette of renderable per LSysObject::BoneFormat => upload bytes per frame, median of animWindBlow() (BoneKernel + packing) and
+*  median vertices/s of a CPU replica of the skinning loop of the vertex shaders (GPU cost can't be timed before any renderer exists)
+*	>> [INFO]	max error := distance of the skinned positions to those of BoneFormat::Matrix
+*	>> [INFO]	getBoneFormat() of renderable is restored afterwards
+*/
+void benchmarkBoneFormats(pje::engine::types::LSysObject& renderable, uint8_t runs) {
+	using BoneFormat = pje::engine::types::LSysObject::BoneFormat;
+
+	const float deltaChange		= 1.0f;
+	const float blowStrength	= 1.0f;
+	const BoneFormat original	= renderable.getBoneFormat();
+	const auto& vertices		= renderable.m_vertices;
+	const auto& boneRefs		= renderable.m_boneRefs;
+
+	auto measure = [runs](const auto& animate) {
+		std::vector<size_t> durations;
+		for (uint8_t run = 0; run < runs; run++) {
+			auto start = std::chrono::steady_clock::now();
+			animate();
+			durations.push_back(static_cast<size_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+		}
+		return getMedian(durations);
+	};
+
+	/* v rotated by unit quaternion q (x, y, z, w) => quatRotate() of the shaders */
+	auto quatRotate = [](const glm::vec4& q, const glm::vec3& v) {
+		const glm::vec3 axis(q);
+		return v + 2.0f * glm::cross(axis, glm::cross(axis, v) + q.w * v);
+	};
+
+	/* main() of the vertex shaders without the camera => object space position and normal per vertex */
+	auto skin = [&](BoneFormat format, std::vector<glm::vec3>& positions, std::vector<glm::vec3>& normals) {
+		const auto* entries = static_cast<const glm::vec4*>(renderable.getBoneData());
+
+		for (size_t v = 0; v < vertices.size(); v++) {
+			const auto& vertex = vertices[v];
+			glm::vec3 position	= vertex.m_boneAttrib.y == 0 ? vertex.m_pos		: glm::vec3(0.0f);
+			glm::vec3 normal	= vertex.m_boneAttrib.y == 0 ? vertex.m_normal	: glm::vec3(0.0f);
+			glm::vec4 real(0.0f);
+			glm::vec4 dual(0.0f);
+
+			for (uint32_t currentBone = 0; currentBone < vertex.m_boneAttrib.y; currentBone++) {
+				const auto& reference = boneRefs[vertex.m_boneAttrib.x + currentBone];
+
+				if (format == BoneFormat::DualQuaternion) {
+					const glm::vec4& boneReal = entries[2 * reference.boneId];
+					const glm::vec4& boneDual = entries[2 * reference.boneId + 1];
+
+					float weight = glm::dot(real, boneReal) < 0.0f ? -reference.weight : reference.weight;
+					real += weight * boneReal;
+					dual += weight * boneDual;
+				}
+				else {
+					glm::mat4 bone = format == BoneFormat::Affine ?
+						glm::transpose(glm::mat4(entries[3 * reference.boneId], entries[3 * reference.boneId + 1], entries[3 * reference.boneId + 2], glm::vec4(0.0f, 0.0f, 0.0f, 1.0f))) :
+						glm::mat4(entries[4 * reference.boneId], entries[4 * reference.boneId + 1], entries[4 * reference.boneId + 2], entries[4 * reference.boneId + 3]);
+
+					position	+= reference.weight * glm::vec3(bone * glm::vec4(vertex.m_pos, 1.0f));
+					normal		+= reference.weight * (glm::transpose(glm::inverse(glm::mat3(bone))) * vertex.m_normal);
+				}
+			}
+
+			if (format == BoneFormat::DualQuaternion && vertex.m_boneAttrib.y > 0) {
+				float norm = glm::length(real);
+				real /= norm;
+				dual /= norm;
+				glm::vec3 translation = 2.0f * (real.w * glm::vec3(dual) - dual.w * glm::vec3(real) + glm::cross(glm::vec3(real), glm::vec3(dual)));
+
+				position	= quatRotate(real, vertex.m_pos) + translation;
+				normal		= quatRotate(real, vertex.m_normal);
+			}
+
+			positions[v]	= position;
+			normals[v]		= normal;
+		}
+	};
+
+	std::vector<glm::vec3> reference(vertices.size());
+	std::vector<glm::vec3> positions(vertices.size());
+	std::vector<glm::vec3> normals(vertices.size());
+
+	std::cout << "[PJE] \tBone palette benchmark (median of " << static_cast<int>(runs) << " runs): " << renderable.m_bones.size() << " bones | " << vertices.size() << " vertices\n";
+	for (auto format : { BoneFormat::Matrix, BoneFormat::Affine, BoneFormat::DualQuaternion }) {
+		renderable.setBoneFormat(format);
+
+		double animMedian = measure([&]() {
+			renderable.animWindBlow(deltaChange, blowStrength);
+		});
+		double skinMedian = measure([&]() {
+			skin(format, positions, normals);
+		});
+
+		/* BoneFormat::Matrix comes first => reference of the compact formats */
+		if (format == BoneFormat::Matrix)
+			reference = positions;
+
+		float maxError = 0.0f;
+		for (size_t v = 0; v < vertices.size(); v++)
+			maxError = std::max(maxError, glm::length(positions[v] - reference[v]));
+
+		const char* name = format == BoneFormat::Matrix ? "Matrix" : format == BoneFormat::Affine ? "Affine" : "DualQuaternion";
+		std::cout << 
+			"\t\t" << name << " : \t" << renderable.getBoneStride() << " bytes/bone | " << renderable.getBoneStride() * renderable.m_bones.size() << " bytes/frame\n" <<
+			"\t\t\tanimWindBlow : \t" << animMedian * 1e-3 << "us\n" <<
+			"\t\t\tskinning : \t" << skinMedian * 1e-3 << "us | " << vertices.size() / (skinMedian * 1e-9) << " vertices/s | max error " << maxError << "\n";
+	}
+	std::cout << std::endl;
+
+	renderable.setBoneFormat(original);
+}
@@ -1,10 +1,10 @@
 #version 450
 
 /* Input | Output */
-layout(location = 0) in vec3	pos;
-layout(location = 1) in vec3	normal;
-layout(location = 2) in vec2	uv;
-layout(location = 3) in uvec2	boneAttrib;		// uvec2{offset, count}
+layout(location = 0) in vec3	pos;			// CompactVertex: unorm16 inside of the AABB of the current primitive
+layout(location = 1) in vec3	normal;			// CompactVertex: xy := octahedral snorm16
+layout(location = 2) in vec2	uv;				// CompactVertex: half float
+layout(location = 3) in uvec2	boneAttrib;		// uvec2{offset, count} | CompactVertex: offset relative to boneRefBase
 
 layout(location = 0) out VertexOut {
 	vec3 normal;
@@ -13,7 +13,7 @@ layout(location = 0) out VertexOut {
 
 /* additional Shader Types */
 struct BoneReference {
-	uint	boneId;		// index into boneMatrices
+	uint	boneId;		// index into bonePalette
 	float	weight;		// value between 0 and 1
 };
 
@@ -29,35 +29,99 @@ layout(set = 0, binding = 0, std140) uniform Matrices {
 	mat4 projectionMatrix;
 } matrices;
 
+/* Push Constants => set per draw call for CompactVertex */
+layout(push_constant) uniform VertexDecode {
+	vec3	positionMin;		// AABB of the current primitive
+	uint	boneRefBase;		// added to boneAttrib[0]
+	vec3	positionExtent;
+	uint	compact;			// 0 => Vertex
+} decode;
+
+/* Specialization Constants => BoneFormat of LSysObject (0 := Matrix | 1 := Affine | 2 := DualQuaternion) */
+layout(constant_id = 0) const uint boneFormat = 0;
+
 /* Storage Buffers */
 layout(set = 0, binding = 1, std430) readonly buffer BoneRefs {
-	BoneReference reference[];	// references into boneMatrices
+	BoneReference reference[];	// references into bonePalette
 } boneRefs;
 
-layout(set = 0, binding = 2, std140) readonly buffer BoneMatrices {
-	mat4 matrix[];				// O_i' x O_i^-1 : modelspace => bonespace => modelspace
-} boneMatrices;
+layout(set = 0, binding = 2, std430) readonly buffer BonePalette {
+	vec4 entry[];				// per bone: Matrix := 4 columns | Affine := 3 rows | DualQuaternion := real, dual
+} bonePalette;
+
+/* octahedral normal (snorm16) => unit vector */
+vec3 octahedralDecode(vec2 encoded) {
+	vec3 n		= vec3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+	float fold	= max(-n.z, 0.0f);
+	n.x += n.x >= 0.0f ? -fold : fold;
+	n.y += n.y >= 0.0f ? -fold : fold;
+	return normalize(n);
+}
+
+/* Matrix | Affine => O_i' x O_i^-1 : modelspace => bonespace => modelspace */
+mat4 boneMatrix(uint boneId) {
+	/* rows of the upper 3x4 => last row (0, 0, 0, 1) */
+	if (boneFormat == 1)
+		return transpose(mat4(bonePalette.entry[3 * boneId], bonePalette.entry[3 * boneId + 1], bonePalette.entry[3 * boneId + 2], vec4(0.0f, 0.0f, 0.0f, 1.0f)));
+
+	return mat4(bonePalette.entry[4 * boneId], bonePalette.entry[4 * boneId + 1], bonePalette.entry[4 * boneId + 2], bonePalette.entry[4 * boneId + 3]);
+}
+
+/* v rotated by unit quaternion q (x, y, z, w) */
+vec3 quatRotate(vec4 q, vec3 v) {
+	return v + 2.0f * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
 
 /* ENTRY POINT */
 void main() {
+	/* CompactVertex => object space | Vertex => unchanged (compact == 0) */
+	vec3	objectPos		= decode.compact == 1 ? decode.positionMin + pos * decode.positionExtent	: pos;
+	vec3	objectNormal	= decode.compact == 1 ? octahedralDecode(normal.xy)						: normal;
+	uvec2	bones			= uvec2(boneAttrib[0] + decode.boneRefBase, boneAttrib[1]);
+
 	/* either uses attributes in restpose or calculates them for animationpose in upcoming for-loop */
-	vec4 animationPos_weighted	= boneAttrib[1] == 0 ? vec4(pos, 1.0f)	: vec4(0.0f);
-	vertexOut.normal			= boneAttrib[1] == 0 ? vec3(normal)		: vec3(0.0f);
-
-	/* boneAttrib[1] holds number of bones connected to vertex */
-	for (uint currentBone = 0; currentBone < boneAttrib[1]; currentBone++) {
-		/* puts vertex into bonespace to calculate new position in modelspace | calculates weighted animationPos */
-		vec4 animationPos = boneMatrices.matrix[boneRefs.reference[boneAttrib[0] + currentBone].boneId] * vec4(pos, 1.0f);
-		animationPos_weighted += boneRefs.reference[boneAttrib[0] + currentBone].weight * animationPos;
-
-		/* transpose(inverse(<matrix>)) to preserve normal | mat3 => rotation matrix */
-		vertexOut.normal +=
-			boneRefs.reference[boneAttrib[0] + currentBone].weight * 
-			transpose(inverse(mat3(boneMatrices.matrix[boneRefs.reference[boneAttrib[0] + currentBone].boneId]))) * 
-			vec3(normal);
+	vec4 animationPos_weighted	= bones[1] == 0 ? vec4(objectPos, 1.0f)	: vec4(0.0f);
+	vertexOut.normal			= bones[1] == 0 ? objectNormal		: vec3(0.0f);
+
+	/* DualQuaternion => weighted sum of the bones is applied once after the loop */
+	vec4 real = vec4(0.0f);
+	vec4 dual = vec4(0.0f);
+
+	/* bones[1] holds number of bones connected to vertex */
+	for (uint currentBone = 0; currentBone < bones[1]; currentBone++) {
+		BoneReference reference = boneRefs.reference[bones[0] + currentBone];
+
+		if (boneFormat == 2) {
+			vec4 boneReal = bonePalette.entry[2 * reference.boneId];
+			vec4 boneDual = bonePalette.entry[2 * reference.boneId + 1];
+
+			/* q and -q are the same rotation => blends along the shorter path */
+			float weight = dot(real, boneReal) < 0.0f ? -reference.weight : reference.weight;
+			real += weight * boneReal;
+			dual += weight * boneDual;
+		}
+		else {
+			/* puts vertex into bonespace to calculate new position in modelspace | calculates weighted animationPos */
+			mat4 bone = boneMatrix(reference.boneId);
+			animationPos_weighted += reference.weight * (bone * vec4(objectPos, 1.0f));
+
+			/* transpose(inverse(<matrix>)) to preserve normal | mat3 => rotation matrix */
+			vertexOut.normal += reference.weight * transpose(inverse(mat3(bone))) * objectNormal;
+		}
+	}
+
+	/* normalized blend => rotation by real | translation := 2 * (dual * conjugate(real)).xyz | normal needs no inverse */
+	if (boneFormat == 2 && bones[1] > 0) {
+		float norm			= length(real);
+		real				/= norm;
+		dual				/= norm;
+		vec3 translation	= 2.0f * (real.w * dual.xyz - dual.w * real.xyz + cross(real.xyz, dual.xyz));
+
+		animationPos_weighted	= vec4(quatRotate(real, objectPos) + translation, 1.0f);
+		vertexOut.normal		= quatRotate(real, objectNormal);
 	}
 
-	/* per Instance logic => gl_InstanceIndex */
+	/* per Instance logic => gl_InstanceIndex (includes firstInstance := firstObject of the current LOD run) */
 	vec4 posOut = matrices.modelMatrix * vec4(animationPos_weighted.xyz, 1.0f);
 	posOut.z += gl_InstanceIndex * 1.5f;
 
@@ -0,0 +1,160 @@
+#version 450
+
+/* Input | Output */
+layout(location = 0) in vec3	pos;			// CompactVertex: unorm16 inside of the AABB of the current source primitive
+layout(location = 1) in vec3	normal;			// CompactVertex: xy := octahedral snorm16
+layout(location = 2) in vec2	uv;				// CompactVertex: half float
+layout(location = 3) in uvec2	boneAttrib;		// unused => bone references are part of each PrimitiveInstance
+
+struct VertexData {
+	vec3 normal;
+	vec2 uv;
+};
+out VertexData vertexData;
+
+/* additional Shader Types */
+struct BoneReference {
+	uint	boneId;		// index into bonePalette
+	float	weight;		// value between 0 and 1
+};
+
+struct PrimitiveInstance {
+	mat4	transform;		// primitive space => model space
+	uint	primitiveId;	// source primitive of this instance
+	uint	boneRefId;		// first reference into boneRefs
+	uint	boneRefCount;	// 0 => restpose only
+	uint	depth;			// nesting depth of its branch => sorted per primitiveId
+};
+
+/* VertexDecode - CompactVertex => primitive space (compact == 0 => Vertex) */
+struct VertexDecode {
+	vec3	positionMin;		// AABB of the current source primitive
+	uint	boneRefBase;		// unused => bone references are part of each PrimitiveInstance
+	vec3	positionExtent;
+	uint	compact;
+};
+
+/* Uniform Buffers */
+layout(binding = 0, std140) uniform Matrices {
+	mat4 mvp;
+	mat4 modelMatrix;
+	mat4 viewMatrix;
+	mat4 projectionMatrix;
+} matrices;
+
+/* Uniforms => set per draw call */
+uniform uvec2 instanceRange;	// uvec2{first, count} of visibleInstances for the current source primitive
+uniform uint firstObject;		// first object of the current LOD run
+uniform VertexDecode decode;	// CompactVertex only
+uniform uint boneFormat;		// BoneFormat of LSysObject (0 := Matrix | 1 := Affine | 2 := DualQuaternion) => set once
+
+/* Storage Buffers */
+layout(binding = 0, std430) readonly buffer BoneRefs {
+	BoneReference reference[];	// references into bonePalette
+} boneRefs;
+
+layout(binding = 1, std430) readonly buffer BonePalette {
+	vec4 entry[];				// per bone: Matrix := 4 columns | Affine := 3 rows | DualQuaternion := real, dual
+} bonePalette;
+
+layout(binding = 2, std430) readonly buffer Instances {
+	PrimitiveInstance instance[];	// grouped by primitiveId
+} instances;
+
+layout(binding = 3, std430) readonly buffer VisibleInstances {
+	uint index[];				// indices into instances of the view frustum => compacted per primitiveId (LSysObject::cullInstances)
+} visibleInstances;
+
+/* octahedral normal (snorm16) => unit vector */
+vec3 octahedralDecode(vec2 encoded) {
+	vec3 n		= vec3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+	float fold	= max(-n.z, 0.0f);
+	n.x += n.x >= 0.0f ? -fold : fold;
+	n.y += n.y >= 0.0f ? -fold : fold;
+	return normalize(n);
+}
+
+/* Matrix | Affine => O_i' x O_i^-1 : modelspace => bonespace => modelspace */
+mat4 boneMatrix(uint boneId) {
+	/* rows of the upper 3x4 => last row (0, 0, 0, 1) */
+	if (boneFormat == 1)
+		return transpose(mat4(bonePalette.entry[3 * boneId], bonePalette.entry[3 * boneId + 1], bonePalette.entry[3 * boneId + 2], vec4(0.0f, 0.0f, 0.0f, 1.0f)));
+
+	return mat4(bonePalette.entry[4 * boneId], bonePalette.entry[4 * boneId + 1], bonePalette.entry[4 * boneId + 2], bonePalette.entry[4 * boneId + 3]);
+}
+
+/* v rotated by unit quaternion q (x, y, z, w) */
+vec3 quatRotate(vec4 q, vec3 v) {
+	return v + 2.0f * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+/* ENTRY POINT */
+void main() {
+	/* CompactVertex => primitive space | Vertex => unchanged (compact == 0) */
+	vec3	objectPos		= decode.compact == 1 ? decode.positionMin + pos * decode.positionExtent	: pos;
+	vec3	objectNormal	= decode.compact == 1 ? octahedralDecode(normal.xy)						: normal;
+
+	/* gl_InstanceID := (object - firstObject) * instanceRange[1] + instance of current source primitive */
+	PrimitiveInstance current	= instances.instance[visibleInstances.index[instanceRange[0] + gl_InstanceID % instanceRange[1]]];
+	uint object					= firstObject + gl_InstanceID / instanceRange[1];
+
+	/* primitive space => model space (restpose) */
+	vec3 modelPos		= (current.transform * vec4(objectPos, 1.0f)).xyz;
+	vec3 modelNormal	= transpose(inverse(mat3(current.transform))) * objectNormal;
+
+	/* either uses attributes in restpose or calculates them for animationpose in upcoming for-loop */
+	vec4 animationPos_weighted	= current.boneRefCount == 0 ? vec4(modelPos, 1.0f)	: vec4(0.0f);
+	vertexData.normal			= current.boneRefCount == 0 ? modelNormal			: vec3(0.0f);
+
+	/* DualQuaternion => weighted sum of the bones is applied once after the loop */
+	vec4 real = vec4(0.0f);
+	vec4 dual = vec4(0.0f);
+
+	/* current.boneRefCount holds number of bones connected to instance */
+	for (uint currentBone = 0; currentBone < current.boneRefCount; currentBone++) {
+		BoneReference reference = boneRefs.reference[current.boneRefId + currentBone];
+
+		if (boneFormat == 2) {
+			vec4 boneReal = bonePalette.entry[2 * reference.boneId];
+			vec4 boneDual = bonePalette.entry[2 * reference.boneId + 1];
+
+			/* q and -q are the same rotation => blends along the shorter path */
+			float weight = dot(real, boneReal) < 0.0f ? -reference.weight : reference.weight;
+			real += weight * boneReal;
+			dual += weight * boneDual;
+		}
+		else {
+			/* puts vertex into bonespace to calculate new position in modelspace | calculates weighted animationPos */
+			mat4 bone = boneMatrix(reference.boneId);
+			animationPos_weighted += reference.weight * (bone * vec4(modelPos, 1.0f));
+
+			/* transpose(inverse(<matrix>)) to preserve normal | mat3 => rotation matrix */
+			vertexData.normal += reference.weight * transpose(inverse(mat3(bone))) * modelNormal;
+		}
+	}
+
+	/* normalized blend => rotation by real | translation := 2 * (dual * conjugate(real)).xyz | normal needs no inverse */
+	if (boneFormat == 2 && current.boneRefCount > 0) {
+		float norm			= length(real);
+		real				/= norm;
+		dual				/= norm;
+		vec3 translation	= 2.0f * (real.w * dual.xyz - dual.w * real.xyz + cross(real.xyz, dual.xyz));
+
+		animationPos_weighted	= vec4(quatRotate(real, modelPos) + translation, 1.0f);
+		vertexData.normal		= quatRotate(real, modelNormal);
+	}
+
+	/* per Object logic => object */
+	vec4 posOut = matrices.modelMatrix * vec4(animationPos_weighted.xyz, 1.0f);
+	posOut.z += object * 1.5f;
+
+	/* vertex shader output */
+	gl_Position = matrices.projectionMatrix * matrices.viewMatrix * posOut;
+
+	/* transpose(inverse(<matrix>)) to preserve normal */
+	vertexData.normal = 
+		(matrices.viewMatrix * transpose(inverse(matrices.modelMatrix)) * 
+		vec4(vertexData.normal, 0.0f)).xyz;
+
+	vertexData.uv = uv;
+}
\ No newline at end of file
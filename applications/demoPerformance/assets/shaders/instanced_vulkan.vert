@@ -0,0 +1,162 @@
+#version 450
+
+/* Input | Output */
+layout(location = 0) in vec3	pos;			// CompactVertex: unorm16 inside of the AABB of the current source primitive
+layout(location = 1) in vec3	normal;			// CompactVertex: xy := octahedral snorm16
+layout(location = 2) in vec2	uv;				// CompactVertex: half float
+layout(location = 3) in uvec2	boneAttrib;		// unused => bone references are part of each PrimitiveInstance
+
+layout(location = 0) out VertexOut {
+	vec3 normal;
+	vec2 uv;
+} vertexOut;
+
+/* additional Shader Types */
+struct BoneReference {
+	uint	boneId;		// index into bonePalette
+	float	weight;		// value between 0 and 1
+};
+
+struct PrimitiveInstance {
+	mat4	transform;		// primitive space => model space
+	uint	primitiveId;	// source primitive of this instance
+	uint	boneRefId;		// first reference into boneRefs
+	uint	boneRefCount;	// 0 => restpose only
+	uint	depth;			// nesting depth of its branch => sorted per primitiveId
+};
+
+/* Vulkan-specific part: */
+// set = DescriptorSetLayout | binding = VkDescriptorSetLayoutBinding of DescriptorSetLayout
+// std = layout convention => std140 (vec4 layout) | std430 (no vec4 layout)
+
+/* Uniform Buffers */
+layout(set = 0, binding = 0, std140) uniform Matrices {
+	mat4 mvp;
+	mat4 modelMatrix;
+	mat4 viewMatrix;
+	mat4 projectionMatrix;
+} matrices;
+
+/* Push Constants => set per draw call */
+layout(push_constant) uniform InstanceRange {
+	vec3	positionMin;		// VertexDecode: AABB of the current source primitive
+	uint	boneRefBase;		// VertexDecode: unused => bone references are part of each PrimitiveInstance
+	vec3	positionExtent;
+	uint	compact;			// VertexDecode: 0 => Vertex
+	uint	first;				// first visible instance of the current source primitive => index into visibleInstances
+	uint	count;				// visible instances of the current source primitive
+} instanceRange;
+
+/* Specialization Constants => BoneFormat of LSysObject (0 := Matrix | 1 := Affine | 2 := DualQuaternion) */
+layout(constant_id = 0) const uint boneFormat = 0;
+
+/* Storage Buffers */
+layout(set = 0, binding = 1, std430) readonly buffer BoneRefs {
+	BoneReference reference[];	// references into bonePalette
+} boneRefs;
+
+layout(set = 0, binding = 2, std430) readonly buffer BonePalette {
+	vec4 entry[];				// per bone: Matrix := 4 columns | Affine := 3 rows | DualQuaternion := real, dual
+} bonePalette;
+
+layout(set = 0, binding = 4, std430) readonly buffer Instances {
+	PrimitiveInstance instance[];	// grouped by primitiveId
+} instances;
+
+layout(set = 0, binding = 5, std430) readonly buffer VisibleInstances {
+	uint index[];				// indices into instances of the view frustum => compacted per primitiveId (LSysObject::cullInstances)
+} visibleInstances;
+
+/* octahedral normal (snorm16) => unit vector */
+vec3 octahedralDecode(vec2 encoded) {
+	vec3 n		= vec3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+	float fold	= max(-n.z, 0.0f);
+	n.x += n.x >= 0.0f ? -fold : fold;
+	n.y += n.y >= 0.0f ? -fold : fold;
+	return normalize(n);
+}
+
+/* Matrix | Affine => O_i' x O_i^-1 : modelspace => bonespace => modelspace */
+mat4 boneMatrix(uint boneId) {
+	/* rows of the upper 3x4 => last row (0, 0, 0, 1) */
+	if (boneFormat == 1)
+		return transpose(mat4(bonePalette.entry[3 * boneId], bonePalette.entry[3 * boneId + 1], bonePalette.entry[3 * boneId + 2], vec4(0.0f, 0.0f, 0.0f, 1.0f)));
+
+	return mat4(bonePalette.entry[4 * boneId], bonePalette.entry[4 * boneId + 1], bonePalette.entry[4 * boneId + 2], bonePalette.entry[4 * boneId + 3]);
+}
+
+/* v rotated by unit quaternion q (x, y, z, w) */
+vec3 quatRotate(vec4 q, vec3 v) {
+	return v + 2.0f * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+/* ENTRY POINT */
+void main() {
+	/* CompactVertex => primitive space | Vertex => unchanged (compact == 0) */
+	vec3	objectPos		= instanceRange.compact == 1 ? instanceRange.positionMin + pos * instanceRange.positionExtent	: pos;
+	vec3	objectNormal	= instanceRange.compact == 1 ? octahedralDecode(normal.xy)						: normal;
+
+	/* gl_InstanceIndex := object * instanceRange.count + instance of current source primitive | firstInstance := firstObject * instanceRange.count */
+	PrimitiveInstance current	= instances.instance[visibleInstances.index[instanceRange.first + gl_InstanceIndex % instanceRange.count]];
+	uint object					= gl_InstanceIndex / instanceRange.count;
+
+	/* primitive space => model space (restpose) */
+	vec3 modelPos		= (current.transform * vec4(objectPos, 1.0f)).xyz;
+	vec3 modelNormal	= transpose(inverse(mat3(current.transform))) * objectNormal;
+
+	/* either uses attributes in restpose or calculates them for animationpose in upcoming for-loop */
+	vec4 animationPos_weighted	= current.boneRefCount == 0 ? vec4(modelPos, 1.0f)	: vec4(0.0f);
+	vertexOut.normal			= current.boneRefCount == 0 ? modelNormal			: vec3(0.0f);
+
+	/* DualQuaternion => weighted sum of the bones is applied once after the loop */
+	vec4 real = vec4(0.0f);
+	vec4 dual = vec4(0.0f);
+
+	/* current.boneRefCount holds number of bones connected to instance */
+	for (uint currentBone = 0; currentBone < current.boneRefCount; currentBone++) {
+		BoneReference reference = boneRefs.reference[current.boneRefId + currentBone];
+
+		if (boneFormat == 2) {
+			vec4 boneReal = bonePalette.entry[2 * reference.boneId];
+			vec4 boneDual = bonePalette.entry[2 * reference.boneId + 1];
+
+			/* q and -q are the same rotation => blends along the shorter path */
+			float weight = dot(real, boneReal) < 0.0f ? -reference.weight : reference.weight;
+			real += weight * boneReal;
+			dual += weight * boneDual;
+		}
+		else {
+			/* puts vertex into bonespace to calculate new position in modelspace | calculates weighted animationPos */
+			mat4 bone = boneMatrix(reference.boneId);
+			animationPos_weighted += reference.weight * (bone * vec4(modelPos, 1.0f));
+
+			/* transpose(inverse(<matrix>)) to preserve normal | mat3 => rotation matrix */
+			vertexOut.normal += reference.weight * transpose(inverse(mat3(bone))) * modelNormal;
+		}
+	}
+
+	/* normalized blend => rotation by real | translation := 2 * (dual * conjugate(real)).xyz | normal needs no inverse */
+	if (boneFormat == 2 && current.boneRefCount > 0) {
+		float norm			= length(real);
+		real				/= norm;
+		dual				/= norm;
+		vec3 translation	= 2.0f * (real.w * dual.xyz - dual.w * real.xyz + cross(real.xyz, dual.xyz));
+
+		animationPos_weighted	= vec4(quatRotate(real, modelPos) + translation, 1.0f);
+		vertexOut.normal		= quatRotate(real, modelNormal);
+	}
+
+	/* per Object logic => object */
+	vec4 posOut = matrices.modelMatrix * vec4(animationPos_weighted.xyz, 1.0f);
+	posOut.z += object * 1.5f;
+
+	/* vertex shader output */
+	gl_Position = matrices.projectionMatrix * matrices.viewMatrix * posOut;
+
+	/* transpose(inverse(<matrix>)) to preserve normal */
+	vertexOut.normal = 
+		(matrices.viewMatrix * transpose(inverse(matrices.modelMatrix)) * 
+		vec4(vertexOut.normal, 0.0f)).xyz;
+
+	vertexOut.uv = uv;
+}
\ No newline at end of file
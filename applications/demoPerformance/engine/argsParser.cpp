@@ -9,7 +9,7 @@ pje::engine::ArgsParser::ArgsParser(int argc, char** argv, uint8_t valid_argc) {
 
 	/* map for regex evaluation | <argName>(s) */
 	std::unordered_map<std::string, int> validLiterals{
-		{"a", 0}, {"c", 1}, {"w", 2}, {"h", 3}, {"vsync", 4}, {"env", 5}
+		{"a", 0}, {"c", 1}, {"w", 2}, {"h", 3}, {"vsync", 4}, {"env", 5}, {"derive", 6}, {"mem", 7}, {"seed", 8}, {"cache", 9}
 	};
 
 	for (uint8_t i = 1; i < argc; i++) {
@@ -43,6 +43,22 @@ pje::engine::ArgsParser::ArgsParser(int argc, char** argv, uint8_t valid_argc) {
 			case 5:
 				this->m_graphicsAPI = smatch[2];
 				break;
+			/* 6 => derivation mode of LSysGenerator */
+			case 6:
+				this->m_derivation = smatch[2];
+				break;
+			/* 7 => memory budget in MiB */
+			case 7:
+				this->m_memoryBudget = std::stoul(smatch[2]);
+				break;
+			/* 8 => seed of stochastic L-System */
+			case 8:
+				this->m_seed = std::stoull(smatch[2]);
+				break;
+			/* 9 => directory of LSysCache */
+			case 9:
+				this->m_cacheDirectory = smatch[2];
+				break;
 			/* invalid argument */
 			default:
 				std::cout << "[PJE] \tInvalid argument was found.\n";
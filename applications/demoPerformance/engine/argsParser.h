@@ -21,13 +21,18 @@ namespace pje::engine {
 		uint16_t		m_height				= 100;
 		bool			m_vsync					= 0;
 		std::string		m_graphicsAPI			= "";
+		std::string		m_derivation			= "parallel";
+		uint32_t		m_memoryBudget			= 0;			// MiB | 0 => unlimited
+		uint64_t		m_seed					= 0;			// 0 => deterministic L-System
+		std::string		m_cacheDirectory		= "";			// "" => derived words aren't cached | --cache=<directory> => LSysCache
 
 		ArgsParser() = delete;
 		/* STANDARD CONSTRUCTOR 
-		*	program expects max. 6 arguments for its members :
+		*	program expects max. 10 arguments for its members :
 		*		*.exe --a=<objectAmount> --c=<objectComplexity> --w=<windowWidth> --h=<windowHeight> --vsync=<0||1> --env=<vulkan/opengl>
+		*		--derive=<sequential/parallel/streaming/dag> --mem=<memoryBudgetMiB> --seed=<stochasticSeed> --cache=<directory>
 		*/
-		ArgsParser(int argc, char** arcv, uint8_t valid_argc = 7);
+		ArgsParser(int argc, char** arcv, uint8_t valid_argc = 11);
 		~ArgsParser();
 
 	private:
@@ -0,0 +1,307 @@
+#include "boneKernel.h"
+
+/* intrinsics are x86 specific => kept out of boneKernel.h */
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define PJE_BONE_KERNEL_X86
+	#include <immintrin.h>
+	#if defined(_MSC_VER)
+		#define PJE_TARGET_SSE
+		#define PJE_TARGET_AVX2
+	#else
+		#define PJE_TARGET_SSE	__attribute__((target("sse2")))
+		#define PJE_TARGET_AVX2	__attribute__((target("avx2,fma")))
+	#endif
+#endif
+
+#include <cmath>
+#include <array>
+#include <numeric>
+#include <algorithm>
+#include <execution>
+
+namespace {
+	/* column of a BoneMatrix as floats => 16 byte aligned via alignas(64) */
+	inline float* columnOf(pje::engine::types::BoneMatrix& bone, int column) {
+		return reinterpret_cast<float*>(&bone.matrix) + 4 * column;
+	}
+
+#if defined(PJE_BONE_KERNEL_X86)
+	/* SoA (x, y, z, w) of 4 bones => 1 column of each of their BoneMatrices */
+	PJE_TARGET_SSE inline void storeColumn(pje::engine::types::BoneMatrix* palette, int column, __m128 x, __m128 y, __m128 z, __m128 w) {
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		_mm_store_ps(columnOf(palette[0], column), x);
+		_mm_store_ps(columnOf(palette[1], column), y);
+		_mm_store_ps(columnOf(palette[2], column), z);
+		_mm_store_ps(columnOf(palette[3], column), w);
+	}
+
+	/* 4 bones of an AVX2 batch => half 0 := bones 0-3 | half 1 := bones 4-7 */
+	PJE_TARGET_AVX2 inline __m128 halfOf(__m256 v, int half) {
+		return half == 0 ? _mm256_castps256_ps128(v) : _mm256_extractf128_ps(v, 1);
+	}
+#endif
+}
+
+void pje::engine::BoneKernel::windPalette(
+	const pje::engine::types::BoneRestFrames&	frames,
+	pje::engine::types::BoneMatrix*				palette,
+	float										angle,
+	Isa											isa,
+	bool										parallel
+) {
+	const size_t count = frames.size();
+
+	KernelInput input = {
+		{ frames.axisX.data(), frames.axisY.data(), frames.axisZ.data() },
+		{ frames.originX.data(), frames.originY.data(), frames.originZ.data() },
+		std::cos(angle),
+		std::sin(angle)
+	};
+
+	if (!VertexKernel::supports(isa))
+		isa = VertexKernel::getIsa();
+
+	if (!parallel || count < parallelThreshold) {
+		windRange(input, palette, count, isa);
+		return;
+	}
+
+	/* chunks of at least parallelThreshold / 4 bones | multiple of 8 => only the last chunk has a scalar tail */
+	const size_t chunks		= std::min(maxChunks, count / (parallelThreshold / 4));
+	const size_t chunkSize	= ((count + chunks - 1) / chunks + 7) & ~size_t(7);
+
+	std::array<uint32_t, maxChunks> chunkIds;
+	std::iota(chunkIds.begin(), chunkIds.end(), 0);
+
+	std::for_each(
+		std::execution::par,
+		chunkIds.begin(),
+		chunkIds.begin() + chunks,
+		[&](uint32_t chunk) {
+			const size_t first = chunk * chunkSize;
+			if (first >= count)
+				return;
+
+			KernelInput chunkInput = input;
+			for (int axis = 0; axis < 3; axis++) {
+				chunkInput.axis[axis]	+= first;
+				chunkInput.origin[axis]	+= first;
+			}
+			windRange(chunkInput, palette + first, std::min(chunkSize, count - first), isa);
+		}
+	);
+}
+
+void pje::engine::BoneKernel::cascadePalette(
+	const pje::engine::types::BoneRestFrames&	frames,
+	pje::engine::types::BoneMatrix*				palette,
+	Isa											isa,
+	bool										parallel
+) {
+	const uint32_t* parents = frames.parent.data();
+
+	if (!VertexKernel::supports(isa))
+		isa = VertexKernel::getIsa();
+
+	if (!parallel || frames.size() < parallelThreshold) {
+		cascadeRange(parents, palette, 0, frames.size(), isa);
+		return;
+	}
+
+	/* spine := ancestors of every run => global before the runs start */
+	for (const uint32_t bone : frames.spine)
+		cascadeRange(parents, palette, bone, 1, isa);
+
+	/* runs of whole subtrees only read their own bones and the spine */
+	std::for_each(
+		std::execution::par,
+		frames.subtrees.begin(),
+		frames.subtrees.end(),
+		[&](const pje::engine::types::ElementRange& run) {
+			cascadeRange(parents, palette, run.first, run.count, isa);
+		}
+	);
+}
+
+void pje::engine::BoneKernel::windRange(const KernelInput& input, pje::engine::types::BoneMatrix* palette, size_t count, Isa isa) {
+	switch (isa) {
+	case Isa::AVX2:
+		windAVX2(input, palette, count);
+		break;
+	case Isa::SSE:
+		windSSE(input, palette, count);
+		break;
+	default:
+		windScalar(input, palette, 0, count);
+	}
+}
+
+void pje::engine::BoneKernel::windScalar(const KernelInput& input, pje::engine::types::BoneMatrix* palette, size_t first, size_t count) {
+	const float c = input.cosAngle;
+	const float s = input.sinAngle;
+	const float k = 1.0f - c;
+
+	for (size_t i = first; i < first + count; i++) {
+		const float ax = input.axis[0][i], ay = input.axis[1][i], az = input.axis[2][i];
+		const float ox = input.origin[0][i], oy = input.origin[1][i], oz = input.origin[2][i];
+
+		/* R := c * I + s * [axis]x + (1 - c) * axis * axis^T */
+		const float m00 = c + k * ax * ax,		m01 = k * ax * ay - s * az,	m02 = k * ax * az + s * ay;
+		const float m10 = k * ax * ay + s * az,	m11 = c + k * ay * ay,		m12 = k * ay * az - s * ax;
+		const float m20 = k * ax * az - s * ay,	m21 = k * ay * az + s * ax,	m22 = c + k * az * az;
+
+		/* T(origin) * R * T(-origin) => translation := origin - R * origin */
+		float* column0 = columnOf(palette[i], 0);
+		float* column1 = columnOf(palette[i], 1);
+		float* column2 = columnOf(palette[i], 2);
+		float* column3 = columnOf(palette[i], 3);
+		column0[0] = m00;	column0[1] = m10;	column0[2] = m20;	column0[3] = 0.0f;
+		column1[0] = m01;	column1[1] = m11;	column1[2] = m21;	column1[3] = 0.0f;
+		column2[0] = m02;	column2[1] = m12;	column2[2] = m22;	column2[3] = 0.0f;
+		column3[0] = ox - (m00 * ox + m01 * oy + m02 * oz);
+		column3[1] = oy - (m10 * ox + m11 * oy + m12 * oz);
+		column3[2] = oz - (m20 * ox + m21 * oy + m22 * oz);
+		column3[3] = 1.0f;
+	}
+}
+
+void pje::engine::BoneKernel::cascadeRange(const uint32_t* parents, pje::engine::types::BoneMatrix* palette, size_t first, size_t count, Isa isa) {
+	if (isa == Isa::Scalar)
+		cascadeScalar(parents, palette, first, count);
+	else
+		cascadeSSE(parents, palette, first, count);
+}
+
+void pje::engine::BoneKernel::cascadeScalar(const uint32_t* parents, pje::engine::types::BoneMatrix* palette, size_t first, size_t count) {
+	for (size_t i = first; i < first + count; i++) {
+		if (parents[i] != pje::engine::types::Bone::root)
+			palette[i].matrix = palette[parents[i]].matrix * palette[i].matrix;
+	}
+}
+
+#if defined(PJE_BONE_KERNEL_X86)
+
+PJE_TARGET_SSE void pje::engine::BoneKernel::cascadeSSE(const uint32_t* parents, pje::engine::types::BoneMatrix* palette, size_t first, size_t count) {
+	for (size_t i = first; i < first + count; i++) {
+		if (parents[i] == pje::engine::types::Bone::root)
+			continue;
+
+		pje::engine::types::BoneMatrix& parent = palette[parents[i]];
+		const __m128 a0 = _mm_load_ps(columnOf(parent, 0));
+		const __m128 a1 = _mm_load_ps(columnOf(parent, 1));
+		const __m128 a2 = _mm_load_ps(columnOf(parent, 2));
+		const __m128 a3 = _mm_load_ps(columnOf(parent, 3));
+
+		/* column j of parent * local := parent * (column j of local) */
+		for (int column = 0; column < 4; column++) {
+			float* target	= columnOf(palette[i], column);
+			const __m128 b	= _mm_load_ps(target);
+			const __m128 r	= _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(a0, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 0, 0, 0))), _mm_mul_ps(a1, _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 1, 1, 1)))),
+				_mm_add_ps(_mm_mul_ps(a2, _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 2, 2, 2))), _mm_mul_ps(a3, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 3, 3))))
+			);
+			_mm_store_ps(target, r);
+		}
+	}
+}
+
+PJE_TARGET_SSE void pje::engine::BoneKernel::windSSE(const KernelInput& input, pje::engine::types::BoneMatrix* palette, size_t count) {
+	const __m128 c		= _mm_set1_ps(input.cosAngle);
+	const __m128 s		= _mm_set1_ps(input.sinAngle);
+	const __m128 k		= _mm_set1_ps(1.0f - input.cosAngle);
+	const __m128 zero	= _mm_setzero_ps();
+	const __m128 one	= _mm_set1_ps(1.0f);
+
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4) {
+		const __m128 ax = _mm_loadu_ps(input.axis[0] + i),		ay = _mm_loadu_ps(input.axis[1] + i),	az = _mm_loadu_ps(input.axis[2] + i);
+		const __m128 ox = _mm_loadu_ps(input.origin[0] + i),	oy = _mm_loadu_ps(input.origin[1] + i),	oz = _mm_loadu_ps(input.origin[2] + i);
+
+		/* R := c * I + s * [axis]x + (1 - c) * axis * axis^T */
+		const __m128 kx		= _mm_mul_ps(k, ax);
+		const __m128 ky		= _mm_mul_ps(k, ay);
+		const __m128 kxy	= _mm_mul_ps(kx, ay);
+		const __m128 kxz	= _mm_mul_ps(kx, az);
+		const __m128 kyz	= _mm_mul_ps(ky, az);
+		const __m128 sx		= _mm_mul_ps(s, ax);
+		const __m128 sy		= _mm_mul_ps(s, ay);
+		const __m128 sz		= _mm_mul_ps(s, az);
+
+		const __m128 m00 = _mm_add_ps(c, _mm_mul_ps(kx, ax)),	m01 = _mm_sub_ps(kxy, sz),						m02 = _mm_add_ps(kxz, sy);
+		const __m128 m10 = _mm_add_ps(kxy, sz),					m11 = _mm_add_ps(c, _mm_mul_ps(ky, ay)),		m12 = _mm_sub_ps(kyz, sx);
+		const __m128 m20 = _mm_sub_ps(kxz, sy),					m21 = _mm_add_ps(kyz, sx),						m22 = _mm_add_ps(c, _mm_mul_ps(_mm_mul_ps(k, az), az));
+
+		/* translation := origin - R * origin */
+		const __m128 tx = _mm_sub_ps(ox, _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, ox), _mm_mul_ps(m01, oy)), _mm_mul_ps(m02, oz)));
+		const __m128 ty = _mm_sub_ps(oy, _mm_add_ps(_mm_add_ps(_mm_mul_ps(m10, ox), _mm_mul_ps(m11, oy)), _mm_mul_ps(m12, oz)));
+		const __m128 tz = _mm_sub_ps(oz, _mm_add_ps(_mm_add_ps(_mm_mul_ps(m20, ox), _mm_mul_ps(m21, oy)), _mm_mul_ps(m22, oz)));
+
+		/* SoA => columns of 4 BoneMatrices */
+		storeColumn(palette + i, 0, m00, m10, m20, zero);
+		storeColumn(palette + i, 1, m01, m11, m21, zero);
+		storeColumn(palette + i, 2, m02, m12, m22, zero);
+		storeColumn(palette + i, 3, tx, ty, tz, one);
+	}
+
+	windScalar(input, palette, i, count - i);
+}
+
+PJE_TARGET_AVX2 void pje::engine::BoneKernel::windAVX2(const KernelInput& input, pje::engine::types::BoneMatrix* palette, size_t count) {
+	const __m256 c		= _mm256_set1_ps(input.cosAngle);
+	const __m256 s		= _mm256_set1_ps(input.sinAngle);
+	const __m256 k		= _mm256_set1_ps(1.0f - input.cosAngle);
+	const __m128 zero	= _mm_setzero_ps();
+	const __m128 one	= _mm_set1_ps(1.0f);
+
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8) {
+		const __m256 ax = _mm256_loadu_ps(input.axis[0] + i),	ay = _mm256_loadu_ps(input.axis[1] + i),	az = _mm256_loadu_ps(input.axis[2] + i);
+		const __m256 ox = _mm256_loadu_ps(input.origin[0] + i),	oy = _mm256_loadu_ps(input.origin[1] + i),	oz = _mm256_loadu_ps(input.origin[2] + i);
+
+		/* R := c * I + s * [axis]x + (1 - c) * axis * axis^T */
+		const __m256 kx		= _mm256_mul_ps(k, ax);
+		const __m256 ky		= _mm256_mul_ps(k, ay);
+		const __m256 kxy	= _mm256_mul_ps(kx, ay);
+		const __m256 kxz	= _mm256_mul_ps(kx, az);
+		const __m256 kyz	= _mm256_mul_ps(ky, az);
+
+		const __m256 m00 = _mm256_fmadd_ps(kx, ax, c),		m01 = _mm256_fnmadd_ps(s, az, kxy),		m02 = _mm256_fmadd_ps(s, ay, kxz);
+		const __m256 m10 = _mm256_fmadd_ps(s, az, kxy),		m11 = _mm256_fmadd_ps(ky, ay, c),		m12 = _mm256_fnmadd_ps(s, ax, kyz);
+		const __m256 m20 = _mm256_fnmadd_ps(s, ay, kxz),	m21 = _mm256_fmadd_ps(s, ax, kyz),		m22 = _mm256_fmadd_ps(_mm256_mul_ps(k, az), az, c);
+
+		/* translation := origin - R * origin */
+		const __m256 tx = _mm256_sub_ps(ox, _mm256_fmadd_ps(m00, ox, _mm256_fmadd_ps(m01, oy, _mm256_mul_ps(m02, oz))));
+		const __m256 ty = _mm256_sub_ps(oy, _mm256_fmadd_ps(m10, ox, _mm256_fmadd_ps(m11, oy, _mm256_mul_ps(m12, oz))));
+		const __m256 tz = _mm256_sub_ps(oz, _mm256_fmadd_ps(m20, ox, _mm256_fmadd_ps(m21, oy, _mm256_mul_ps(m22, oz))));
+
+		/* SoA => columns of 8 BoneMatrices | 1 half per 4 bones */
+		for (int half = 0; half < 2; half++) {
+			pje::engine::types::BoneMatrix* bones = palette + i + 4 * half;
+			storeColumn(bones, 0, halfOf(m00, half), halfOf(m10, half), halfOf(m20, half), zero);
+			storeColumn(bones, 1, halfOf(m01, half), halfOf(m11, half), halfOf(m21, half), zero);
+			storeColumn(bones, 2, halfOf(m02, half), halfOf(m12, half), halfOf(m22, half), zero);
+			storeColumn(bones, 3, halfOf(tx, half), halfOf(ty, half), halfOf(tz, half), one);
+		}
+	}
+
+	windScalar(input, palette, i, count - i);
+}
+
+#else
+
+/* no x86 => scalar only */
+void pje::engine::BoneKernel::cascadeSSE(const uint32_t* parents, pje::engine::types::BoneMatrix* palette, size_t first, size_t count) {
+	cascadeScalar(parents, palette, first, count);
+}
+
+void pje::engine::BoneKernel::windSSE(const KernelInput& input, pje::engine::types::BoneMatrix* palette, size_t count) {
+	windScalar(input, palette, 0, count);
+}
+
+void pje::engine::BoneKernel::windAVX2(const KernelInput& input, pje::engine::types::BoneMatrix* palette, size_t count) {
+	windScalar(input, palette, 0, count);
+}
+
+#endif
@@ -0,0 +1,66 @@
+/* Ignores header if not needed after #include */
+	#pragma once
+
+/* Third Party Files */
+	#include <cstdint>							// fixed size integer
+	#include <cstddef>							// size_t
+
+/* Project Files */
+	#include "pjeBuffers.h"
+	#include "vertexKernel.h"
+
+namespace pje::engine {
+
+	/* BoneKernel - Writes the BoneMatrices of a wind tilt (rotation around z by angle) for all bones in 1 pass
+	*	>> [INFO]	restpose * R_z(angle) * restposeInv == Rodrigues rotation around BoneRestFrames::axis through origin => no matrix product per bone
+	*	>> [INFO]	batches of 4 (SSE) or 8 (AVX2) bones are read as SoA => transposed into columns of m_bonePalette
+	*	>> [INFO]	from parallelThreshold bones on => chunks are animated via std::execution::par
+	*	>> [INFO]	cascadePalette() composes every BoneMatrix with the one of its parent in pre-order => 1 linear sweep, subtrees concurrently
+	*/
+	class BoneKernel {
+	public:
+		using Isa = VertexKernel::Isa;
+
+		static constexpr size_t parallelThreshold	= 16384;
+		static constexpr size_t maxChunks			= 64;
+
+		BoneKernel() = delete;
+
+		/* palette[i] := T(origin_i) * R(axis_i, angle) * T(-origin_i) for all frames.size() bones | parallel => chunks above parallelThreshold */
+		static void windPalette(
+			const pje::engine::types::BoneRestFrames&	frames,
+			pje::engine::types::BoneMatrix*				palette,
+			float										angle,
+			Isa											isa = VertexKernel::getIsa(),
+			bool										parallel = true
+		);
+		/* palette[i] := palette[parent_i] * palette[i] in pre-order => local poses become global ones | parallel => BoneRestFrames::subtrees above parallelThreshold */
+		static void cascadePalette(
+			const pje::engine::types::BoneRestFrames&	frames,
+			pje::engine::types::BoneMatrix*				palette,
+			Isa											isa = VertexKernel::getIsa(),
+			bool										parallel = true
+		);
+
+	private:
+		/* KernelInput - SoA pointers of 1 chunk and the shared rotation of the tilt */
+		struct KernelInput {
+			const float*	axis[3];
+			const float*	origin[3];
+			float			cosAngle;
+			float			sinAngle;
+		};
+
+		static void windRange(const KernelInput& input, pje::engine::types::BoneMatrix* palette, size_t count, Isa isa);
+
+		static void windScalar(const KernelInput& input, pje::engine::types::BoneMatrix* palette, size_t first, size_t count);
+		static void windSSE(const KernelInput& input, pje::engine::types::BoneMatrix* palette, size_t count);
+		static void windAVX2(const KernelInput& input, pje::engine::types::BoneMatrix* palette, size_t count);
+
+		/* bones [first, first + count) whose parents are already global | 1 mat4 column per SSE register => AVX2 uses SSE */
+		static void cascadeRange(const uint32_t* parents, pje::engine::types::BoneMatrix* palette, size_t first, size_t count, Isa isa);
+
+		static void cascadeScalar(const uint32_t* parents, pje::engine::types::BoneMatrix* palette, size_t first, size_t count);
+		static void cascadeSSE(const uint32_t* parents, pje::engine::types::BoneMatrix* palette, size_t first, size_t count);
+	};
+}
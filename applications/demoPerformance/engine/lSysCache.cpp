@@ -0,0 +1,190 @@
+#include "lSysCache.h"
+
+/* memory mapping is OS specific => kept out of lSysCache.h */
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+pje::engine::LSysCache::MappedFile::MappedFile(const std::filesystem::path& path) : m_data(nullptr), m_size(0), m_file(nullptr), m_mapping(nullptr) {
+#if defined(_WIN32)
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return;
+	m_file = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		return;
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+		return;
+	m_mapping = mapping;
+
+	m_data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	m_size = m_data != nullptr ? static_cast<size_t>(size.QuadPart) : 0;
+#else
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0)
+		return;
+
+	struct stat status;
+	if (fstat(file, &status) == 0 && status.st_size > 0) {
+		void* view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		if (view != MAP_FAILED) {
+			m_data = static_cast<const uint8_t*>(view);
+			m_size = static_cast<size_t>(status.st_size);
+		}
+	}
+
+	/* mapping stays valid after closing its file descriptor */
+	close(file);
+#endif
+}
+
+pje::engine::LSysCache::MappedFile::~MappedFile() {
+#if defined(_WIN32)
+	if (m_data != nullptr)
+		UnmapViewOfFile(m_data);
+	if (m_mapping != nullptr)
+		CloseHandle(m_mapping);
+	if (m_file != nullptr)
+		CloseHandle(m_file);
+#else
+	if (m_data != nullptr)
+		munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+}
+
+const uint8_t* pje::engine::LSysCache::MappedFile::data() const { return m_data; }
+size_t pje::engine::LSysCache::MappedFile::size() const { return m_size; }
+
+/* ################################################################################### */
+
+pje::engine::LSysCache::LSysCache(const std::filesystem::path& directory) : m_directory(directory) {
+	std::error_code error;
+	std::filesystem::create_directories(m_directory, error);
+	if (error)
+		throw std::runtime_error("LSysCache couldn't create its directory: " + m_directory.string());
+}
+
+pje::engine::LSysCache::~LSysCache() {}
+
+uint64_t pje::engine::LSysCache::hash(const void* data, size_t bytes, uint64_t seed) {
+	const uint8_t*	byte	= static_cast<const uint8_t*>(data);
+	uint64_t		result	= seed;
+
+	for (size_t i = 0; i < bytes; i++) {
+		result ^= byte[i];
+		result *= 0x100000001B3ull;
+	}
+
+	return result;
+}
+
+bool pje::engine::LSysCache::load(uint64_t key, PackedWord& word) const {
+	const std::filesystem::path path = pathOf(key);
+
+	std::error_code error;
+	if (!std::filesystem::exists(path, error))
+		return false;
+
+	bool isValid = false;
+	{
+		MappedFile file(path);
+		FileHeader header;
+
+		if (file.data() != nullptr && file.size() >= sizeof(FileHeader)) {
+			std::memcpy(&header, file.data(), sizeof(FileHeader));
+			const uint64_t* blocks = reinterpret_cast<const uint64_t*>(file.data() + sizeof(FileHeader));
+
+			/* cheap header checks first => checksum is only computed for a plausible entry */
+			isValid =
+				header.magic		== LSYS_CACHE_MAGIC &&
+				header.version		== LSYS_CACHE_VERSION &&
+				header.key			== key &&
+				header.bitWidth		== word.getBitWidth() &&
+				header.alphabetSize	== word.getAlphabet().size() &&
+				header.blockCount	== PackedWord::byteSizeOf(header.symbols, header.alphabetSize) / sizeof(uint64_t) &&
+				header.blockCount	== (file.size() - sizeof(FileHeader)) / sizeof(uint64_t) &&
+				file.size()			== sizeof(FileHeader) + header.blockCount * sizeof(uint64_t) &&
+				header.checksum		== checksumOf(header.symbols, blocks, static_cast<size_t>(header.blockCount));
+
+			if (isValid)
+				word.assignBlocks(blocks, static_cast<size_t>(header.symbols));
+		}
+	}
+
+	if (!isValid) {
+		/* stale or corrupt entry => removed and derived again */
+		std::cout << "[PJE] \tLSysCache discards invalid entry: " << path.string() << std::endl;
+		std::filesystem::remove(path, error);
+	}
+
+	return isValid;
+}
+
+bool pje::engine::LSysCache::store(uint64_t key, const PackedWord& word) const {
+	const std::filesystem::path path			= pathOf(key);
+	const std::filesystem::path temporaryPath	= path.string() + ".tmp";
+
+	const size_t blockCount = word.byteSize() / sizeof(uint64_t);
+	FileHeader header{
+		LSYS_CACHE_MAGIC,
+		LSYS_CACHE_VERSION,
+		key,
+		word.size(),
+		blockCount,
+		checksumOf(word.size(), word.data(), blockCount),
+		word.getBitWidth(),
+		static_cast<uint32_t>(word.getAlphabet().size())
+	};
+
+	{
+		std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+		file.write(reinterpret_cast<const char*>(word.data()), static_cast<std::streamsize>(word.byteSize()));
+
+		if (!file.good()) {
+			std::cout << "[PJE] \tLSysCache couldn't write entry: " << temporaryPath.string() << std::endl;
+			return false;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(temporaryPath, path, error);
+	if (error) {
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+
+	return true;
+}
+
+std::filesystem::path pje::engine::LSysCache::pathOf(uint64_t key) const {
+	const char* digits = "0123456789abcdef";
+
+	std::string filename(16, '0');
+	for (size_t i = 0; i < 16; i++)
+		filename[15 - i] = digits[(key >> (i * 4)) & 0xF];
+
+	return m_directory / (filename + ".lsys");
+}
+
+uint64_t pje::engine::LSysCache::checksumOf(uint64_t symbols, const uint64_t* blocks, size_t blockCount) {
+	/* FNV-1a per 64 bit block instead of per byte => checksum of large words costs less than mapping them */
+	uint64_t result = hash(&symbols, sizeof(symbols));
+	for (size_t i = 0; i < blockCount; i++) {
+		result ^= blocks[i];
+		result *= 0x100000001B3ull;
+	}
+
+	return result;
+}
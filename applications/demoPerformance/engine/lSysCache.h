@@ -0,0 +1,82 @@
+/* Ignores header if not needed after #include */
+	#pragma once
+
+/* Third Party Files */
+	#include <cstdint>			// fixed size integer
+	#include <cstring>			// std::memcpy
+	#include <string>			// std::string
+	#include <vector>			// std::vector
+	#include <stdexcept>		// std::runtime_error
+
+	#include <iostream>			// i/o stream
+	#include <fstream>			// write to files
+	#include <filesystem>		// file paths
+
+/* Project Files */
+	#include "packedWord.h"
+
+#define LSYS_CACHE_MAGIC	0x534C4A50u		// "PJLS" in little endian byte order
+#define LSYS_CACHE_VERSION	1u				// increase after any change of FileHeader, PackedWord layout or LSysGenerator::getCacheKey()
+
+namespace pje::engine {
+
+	/* LSysCache - Stores derived words as memory-mappable files => later launches map them instead of deriving them again
+	*	>> [INFO]	file := FileHeader followed by the 64 bit blocks of a PackedWord
+	*	>> [INFO]	filename := hex key (see LSysGenerator::getCacheKey()) + ".lsys"
+	*	>> [INFO]	entries with another magic, version, key, bit width, size or checksum are discarded
+	*/
+	class LSysCache {
+	public:
+		/* FileHeader - 48 bytes => blocks start 8 byte aligned */
+		struct FileHeader {
+			uint32_t	magic;
+			uint32_t	version;
+			uint64_t	key;
+			uint64_t	symbols;		// PackedWord::size()
+			uint64_t	blockCount;		// 64 bit blocks after this header
+			uint64_t	checksum;		// checksumOf(symbols, blocks)
+			uint32_t	bitWidth;		// PackedWord::getBitWidth()
+			uint32_t	alphabetSize;
+		};
+
+		LSysCache() = delete;
+		/* STANDARD CONSTRUCTOR
+		*	>> [INFO]	creates directory if it doesn't exist yet
+		*/
+		explicit LSysCache(const std::filesystem::path& directory);
+		~LSysCache();
+
+		/* FNV-1a over bytes | seed := hash of prior data => hashes can be chained */
+		static uint64_t hash(const void* data, size_t bytes, uint64_t seed = 0xCBF29CE484222325ull);
+
+		/* maps entry of key into word (its alphabet must equal the stored alphabet) | false => missing or invalid entry */
+		bool load(uint64_t key, PackedWord& word) const;
+		/* writes entry of key | temporary file is renamed afterwards => a crash never leaves a truncated entry behind */
+		bool store(uint64_t key, const PackedWord& word) const;
+
+	private:
+		/* MappedFile - read-only view of a whole file */
+		class MappedFile {
+		public:
+			MappedFile() = delete;
+			explicit MappedFile(const std::filesystem::path& path);
+			~MappedFile();
+
+			/* nullptr => file couldn't be mapped */
+			const uint8_t* data() const;
+			size_t size() const;
+
+		private:
+			const uint8_t*	m_data;
+			size_t			m_size;
+			void*			m_file;			// Windows: file handle
+			void*			m_mapping;		// Windows: file mapping handle
+		};
+
+		std::filesystem::path m_directory;
+
+		std::filesystem::path pathOf(uint64_t key) const;
+		/* hashes symbol count and every block => detects truncated and modified entries */
+		static uint64_t checksumOf(uint64_t symbols, const uint64_t* blocks, size_t blockCount);
+	};
+}
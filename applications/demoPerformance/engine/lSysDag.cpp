@@ -0,0 +1,143 @@
+#include "lSysDag.h"
+
+pje::engine::LSysDag::LSysDag(const LSysGenerator& generator) : LSysDag(generator, generator.m_axiom, generator.m_iterations) {}
+
+pje::engine::LSysDag::LSysDag(const LSysGenerator& generator, const std::string& axiom, uint8_t iterations) : m_alphabet(generator.m_alphabet), m_root(0) {
+	/* stochastic productions depend on the position of a symbol => equal sub-derivations can't be shared */
+	if (generator.isStochastic())
+		throw std::runtime_error("LSysDag requires an L-System with deterministic rules.");
+
+	const size_t	depth	= static_cast<size_t>(iterations) + 1;
+	const int16_t	envId	= generator.m_lEnvInput.empty() ? 0 : generator.m_symbolIds[static_cast<uint8_t>(generator.m_lEnvInput[0])];
+
+	std::vector<uint8_t> axiomIds(axiom.size());
+	for (size_t i = 0; i < axiomIds.size(); i++)
+		axiomIds[i] = generator.m_symbolIds[static_cast<uint8_t>(axiom[i])];
+
+	/* virtual root: its successor is the axiom whose left context is the environmental input on every level */
+	m_root = createNode(generator, 0, static_cast<uint16_t>(depth), axiomIds.data(), axiomIds.size(), std::vector<int16_t>(depth, envId));
+
+	/* hash-consing is only needed while building */
+	m_nodeIds.clear();
+}
+
+pje::engine::LSysDag::~LSysDag() {}
+
+uint64_t pje::engine::LSysDag::getLength() const { return m_nodes[m_root].length; }
+size_t pje::engine::LSysDag::getNodeCount() const { return m_nodes.size(); }
+const std::string& pje::engine::LSysDag::getAlphabet() const { return m_alphabet; }
+
+uint64_t pje::engine::LSysDag::getSymbolCount(char symbol) const {
+	size_t symbolId = m_alphabet.find(symbol);
+	if (symbolId == std::string::npos)
+		return 0;
+
+	return m_counts[m_root * m_alphabet.size() + symbolId];
+}
+
+char pje::engine::LSysDag::at(uint64_t index) const {
+	if (index >= getLength())
+		throw std::runtime_error("LSysDag::at() received an index outside of the word.");
+
+	/* skips every child whose expansion lies before index */
+	const Node* node = &m_nodes[m_root];
+	while (node->depth != 0) {
+		for (uint32_t i = 0; i < node->childCount; i++) {
+			const Node& child = m_nodes[m_children[node->firstChild + i]];
+			if (index < child.length) {
+				node = &child;
+				break;
+			}
+			index -= child.length;
+		}
+	}
+
+	return m_alphabet[node->symbolId];
+}
+
+uint32_t pje::engine::LSysDag::buildNode(const LSysGenerator& generator, uint8_t symbolId, uint16_t depth, const std::vector<int16_t>& contextIds) {
+	const bool useContext = !generator.m_lEnvInput.empty();
+
+	/* key := symbol, depth and (1L only) left context of every remaining level */
+	std::string key;
+	key.reserve(3 + (useContext ? depth : 0));
+	key.push_back(static_cast<char>(symbolId));
+	key.push_back(static_cast<char>(depth & 0xFF));
+	key.push_back(static_cast<char>(depth >> 8));
+	if (useContext) {
+		for (uint16_t level = 0; level < depth; level++)
+			key.push_back(static_cast<char>(contextIds[level]));
+	}
+
+	auto existing = m_nodeIds.find(key);
+	if (existing != m_nodeIds.end())
+		return existing->second;
+
+	uint32_t nodeId;
+	if (depth == 0) {
+		/* leaf: symbol of the final word */
+		nodeId = static_cast<uint32_t>(m_nodes.size());
+		m_nodes.push_back(Node{ 1, 0, 0, static_cast<uint32_t>(m_lastIds.size()), symbolId, 0 });
+		m_lastIds.push_back(symbolId);
+		m_counts.resize(m_counts.size() + m_alphabet.size(), 0);
+		m_counts[nodeId * m_alphabet.size() + symbolId] = 1;
+	}
+	else {
+		const size_t symbolCount = m_alphabet.size();
+		const LSysGenerator::RuleEntry& entry = useContext ?
+			generator.m_ruleTable[contextIds[0] * symbolCount + symbolId] :
+			generator.contextFreeRow()[symbolId];
+
+		nodeId = createNode(generator, symbolId, depth, generator.m_successorIds.data() + entry.offset, entry.length, contextIds);
+	}
+
+	m_nodeIds.emplace(std::move(key), nodeId);
+	return nodeId;
+}
+
+uint32_t pje::engine::LSysDag::createNode(const LSysGenerator& generator, uint8_t symbolId, uint16_t depth, const uint8_t* successorIds, size_t successorCount, const std::vector<int16_t>& contextIds) {
+	const size_t symbolCount = m_alphabet.size();
+
+	/* left context of the first child on its levels := left context of this node one level deeper */
+	std::vector<int16_t>	childContextIds(contextIds.begin() + 1, contextIds.begin() + depth);
+	std::vector<uint32_t>	childIds(successorCount);
+
+	for (size_t i = 0; i < successorCount; i++) {
+		childIds[i] = buildNode(generator, successorIds[i], depth - 1, childContextIds);
+
+		/* next child continues after the last symbols of this child on every level */
+		const Node& child = m_nodes[childIds[i]];
+		for (uint16_t level = 0; level + 1 < depth; level++) {
+			int16_t lastId = m_lastIds[child.firstLastId + level];
+			if (lastId >= 0)
+				childContextIds[level] = lastId;
+		}
+	}
+
+	/* node is created after its children => m_nodes may have grown meanwhile */
+	uint32_t nodeId = static_cast<uint32_t>(m_nodes.size());
+	Node node{ 0, static_cast<uint32_t>(m_children.size()), static_cast<uint32_t>(successorCount), static_cast<uint32_t>(m_lastIds.size()), symbolId, depth };
+	m_children.insert(m_children.end(), childIds.begin(), childIds.end());
+
+	/* cached length, per symbol counts and last symbol per level */
+	m_counts.resize(m_counts.size() + symbolCount, 0);
+	m_lastIds.push_back(symbolId);
+	m_lastIds.resize(m_lastIds.size() + depth, -1);
+
+	for (const auto& childId : childIds) {
+		const Node& child = m_nodes[childId];
+		node.length += child.length;
+
+		for (size_t s = 0; s < symbolCount; s++)
+			m_counts[nodeId * symbolCount + s] += m_counts[childId * symbolCount + s];
+
+		for (uint16_t level = 0; level < depth; level++) {
+			int16_t lastId = m_lastIds[child.firstLastId + level];
+			if (lastId >= 0)
+				m_lastIds[node.firstLastId + 1 + level] = lastId;
+		}
+	}
+
+	m_nodes.push_back(node);
+	return nodeId;
+}
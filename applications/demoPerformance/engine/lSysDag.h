@@ -0,0 +1,92 @@
+/* Ignores header if not needed after #include */
+	#pragma once
+
+/* Third Party Files */
+	#include <cstdint>			// fixed size integer
+	#include <string>			// std::string
+	#include <vector>			// std::vector
+	#include <unordered_map>	// hashtable
+	#include <stdexcept>		// std::runtime_error
+
+/* Project Files */
+	#include "lSysGenerator.h"
+
+namespace pje::engine {
+
+	/* LSysDag - Shares every distinct sub-derivation of a LSysGenerator's word as one node (hash-consing)
+	*	>> [INFO]	node := expansion of (symbol, remaining iterations, left context on every remaining level)
+	*	>> [INFO]	every node caches its length and per symbol counts => statistics without flattening
+	*	>> [INFO]	self-similar grammars need a few nodes per iteration instead of the whole word
+	*	>> [INFO]	throws for stochastic L-Systems
+	*/
+	class LSysDag {
+	public:
+		LSysDag() = delete;
+		/* derivation of generator's axiom after generator's iterations */
+		explicit LSysDag(const LSysGenerator& generator);
+		/* derivation of any word of generator's alphabet after iterations */
+		LSysDag(const LSysGenerator& generator, const std::string& axiom, uint8_t iterations);
+		~LSysDag();
+
+		/* length of the final word */
+		uint64_t getLength() const;
+		/* occurrences of symbol inside of the final word */
+		uint64_t getSymbolCount(char symbol) const;
+		size_t getNodeCount() const;
+		const std::string& getAlphabet() const;
+		/* symbol at index of the final word | descends via cached lengths */
+		char at(uint64_t index) const;
+
+		/* calls f(char symbol) for every symbol of the final word | memory: O(iterations) */
+		template <typename Function>
+		void forEachSymbol(Function&& f) const {
+			struct Frame {
+				uint32_t node;
+				uint32_t child;
+			};
+			std::vector<Frame> frames;
+			frames.reserve(static_cast<size_t>(m_nodes[m_root].depth) + 1);
+			frames.push_back(Frame{ m_root, 0 });
+
+			while (!frames.empty()) {
+				Frame&		frame	= frames.back();
+				const Node&	node	= m_nodes[frame.node];
+
+				if (node.depth == 0) {
+					f(m_alphabet[node.symbolId]);
+					frames.pop_back();
+				}
+				else if (frame.child == node.childCount) {
+					frames.pop_back();
+				}
+				else {
+					frames.push_back(Frame{ m_children[node.firstChild + frame.child++], 0 });
+				}
+			}
+		}
+
+	private:
+		/* Node - expansion of symbolId after depth iterations */
+		struct Node {
+			uint64_t	length;			// symbols of final word below this node
+			uint32_t	firstChild;		// m_children[firstChild, firstChild + childCount) := successor of symbolId
+			uint32_t	childCount;
+			uint32_t	firstLastId;	// m_lastIds[firstLastId + level] for level 0 to depth
+			uint8_t		symbolId;
+			uint16_t	depth;			// remaining iterations | 0 => leaf := symbol of final word
+		};
+
+		std::string					m_alphabet;
+		std::vector<Node>			m_nodes;
+		std::vector<uint32_t>		m_children;
+		std::vector<uint64_t>		m_counts;		// [nodeId * |alphabet| + symbolId]
+		std::vector<int16_t>		m_lastIds;		// last symbol id of a node's expansion per level | -1 => empty expansion
+		uint32_t					m_root;			// virtual node above the axiom
+		std::unordered_map<std::string, uint32_t> m_nodeIds;	// build helper: hash-consing key => node id
+
+		/* returns shared node for (symbolId, depth, contextIds[0, depth)) */
+		uint32_t buildNode(const LSysGenerator& generator, uint8_t symbolId, uint16_t depth, const std::vector<int16_t>& contextIds);
+		/* creates a node whose children expand successorIds with depth - 1 remaining iterations */
+		uint32_t createNode(const LSysGenerator& generator, uint8_t symbolId, uint16_t depth, const uint8_t* successorIds, size_t successorCount, const std::vector<int16_t>& contextIds);
+	};
+}
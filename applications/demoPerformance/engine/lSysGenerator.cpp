@@ -1,76 +1,481 @@
 #include "lSysGenerator.h"
+#include "lSysDag.h"
+#include "lSysCache.h"
 
-pje::engine::LSysGenerator::LSysGenerator(std::string alphabet, 
-										  std::string axiom, 
-										  std::unordered_map<std::string, std::string> rules, 
-										  uint8_t iterations, 
-										  std::string envInput) : m_currentLSysWord(""), m_alphabet(alphabet), m_rules(rules) {
-	if (envInput.size() == 0) {
+#define PARALLEL_MIN_SYMBOLS	65536	// smaller words are rewritten sequentially even in DerivationMode::Parallel
+#define PARALLEL_CHUNKS_PER_CORE	8	// oversubscription for load balancing of uneven expansion lengths
+
+pje::engine::LSysGenerator::LSysGenerator(std::string alphabet,
+										  std::string axiom,
+										  std::unordered_map<std::string, std::string> rules,
+										  uint8_t iterations,
+										  std::string envInput,
+										  DerivationMode mode) : LSysGenerator(alphabet, axiom, toProductions(rules), iterations, envInput, mode, 0) {}
+
+pje::engine::LSysGenerator::LSysGenerator(std::string alphabet,
+										  std::string axiom,
+										  std::unordered_map<std::string, std::vector<LSysProduction>> rules,
+										  uint8_t iterations,
+										  std::string envInput,
+										  DerivationMode mode,
+										  uint64_t seed,
+										  const LSysCache* cache) : m_mode(mode), m_currentLSysWord(alphabet), m_backBuffer(alphabet), m_alphabet(alphabet), m_axiom(axiom), m_iterations(iterations), m_rules(rules), m_seed(seed) {
+	/* sets environmental input for 1L-Systems and 2L-Systems */
+	if (envInput.size() != 0)
+		this->m_lEnvInput = envInput.at(0);
+
+	/* flattens m_rules into m_ruleTable */
+	compileRules();
+
+	if (m_mode == DerivationMode::Streaming || m_mode == DerivationMode::Dag) {
+		/* word will be derived on demand by LSysStream or LSysDag */
+		return;
+	}
+	else if (cache != nullptr && cache->load(getCacheKey(), m_currentLSysWord)) {
+		/* word of a prior launch => no derivation */
+		std::cout << "[PJE] \tL-System word was mapped from LSysCache (" << m_currentLSysWord.size() << " symbols)." << std::endl;
+		return;
+	}
+	else if (envInput.size() == 0) {
 		/* generates this->m_currentLSysWord */
 		generate0LSysWord(axiom, iterations);
 	}
 	else {
-		/* sets environmental input for 1L-Systems and 2L-Systems */
-		this->m_lEnvInput = envInput.at(0);
-
 		/* generates this->m_currentLSysWord */
 		generate1LSysWord(axiom, iterations);
 	}
+
+	if (cache != nullptr)
+		cache->store(getCacheKey(), m_currentLSysWord);
 }
 
 pje::engine::LSysGenerator::~LSysGenerator() {}
 
 void pje::engine::LSysGenerator::generate0LSysWord(std::string word, uint8_t iterations) {
-	this->m_currentLSysWord.clear();
+	this->m_iterations = iterations;
+	this->m_currentLSysWord.assign(word);
+	this->m_iterationStats.clear();
+	reserveBuffers(word, iterations, false);
 
-	if (iterations == 0) {
-		this->m_currentLSysWord.append(word);
-		return;
+	/* iterative derivation: every step rewrites front buffer into back buffer */
+	for (uint8_t i = 0; i < iterations; i++) {
+		rewrite(false);
 	}
+}
 
-	for (std::string::size_type i = 0; i <= word.size(); i++) {
-		auto pair = this->m_rules.find(word.substr(i, 1));
-		if (pair != this->m_rules.end()) {
-			this->m_currentLSysWord.append(pair->second);
+void pje::engine::LSysGenerator::generate1LSysWord(std::string word, uint8_t iterations) {
+	this->m_iterations = iterations;
+	this->m_currentLSysWord.assign(word);
+	this->m_iterationStats.clear();
+	reserveBuffers(word, iterations, true);
+
+	/* iterative derivation: every step rewrites front buffer into back buffer */
+	for (uint8_t i = 0; i < iterations; i++) {
+		rewrite(true);
+	}
+}
+
+std::string pje::engine::LSysGenerator::getCurrentLSysWord() const { return m_currentLSysWord.toString(); }
+const pje::engine::PackedWord& pje::engine::LSysGenerator::getPackedLSysWord() const { return m_currentLSysWord; }
+std::string pje::engine::LSysGenerator::getAlphabet() const { return m_alphabet; }
+std::string pje::engine::LSysGenerator::getAxiom() const { return m_axiom; }
+uint8_t pje::engine::LSysGenerator::getIterations() const { return m_iterations; }
+pje::engine::LSysGenerator::DerivationMode pje::engine::LSysGenerator::getDerivationMode() const { return m_mode; }
+void pje::engine::LSysGenerator::setSeed(uint64_t seed) { m_seed = seed; }
+uint64_t pje::engine::LSysGenerator::getSeed() const { return m_seed; }
+bool pje::engine::LSysGenerator::isStochastic() const { return !m_choices.empty(); }
+pje::engine::LSysStream pje::engine::LSysGenerator::getStream() const { return LSysStream(*this); }
+pje::engine::LSysDag pje::engine::LSysGenerator::getDag() const { return LSysDag(*this); }
+const std::vector<pje::engine::LSysGenerator::IterationStats>& pje::engine::LSysGenerator::getIterationStats() const { return m_iterationStats; }
+
+uint64_t pje::engine::LSysGenerator::getCacheKey() const {
+	/* length prefix per string => ("ab", "c") and ("a", "bc") hash differently */
+	uint64_t key = LSysCache::hash(nullptr, 0);
+	auto hashString = [&key](const std::string& text) {
+		uint64_t length = text.size();
+		key = LSysCache::hash(&length, sizeof(length), key);
+		key = LSysCache::hash(text.data(), text.size(), key);
+	};
+
+	hashString(m_alphabet);
+	hashString(m_axiom);
+	hashString(m_lEnvInput);
+	key = LSysCache::hash(&m_iterations, sizeof(m_iterations), key);
+
+	/* m_rules is unordered => sorted by predecessor */
+	std::vector<const std::pair<const std::string, std::vector<LSysProduction>>*> rules;
+	for (const auto& rule : m_rules)
+		rules.push_back(&rule);
+	std::sort(rules.begin(), rules.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+
+	for (const auto* rule : rules) {
+		hashString(rule->first);
+		for (const auto& production : rule->second) {
+			hashString(production.successor);
+			key = LSysCache::hash(&production.weight, sizeof(production.weight), key);
 		}
-		else {
-			this->m_currentLSysWord.append(1, word.at(i));
+	}
+
+	/* deterministic words don't depend on the seed => every seed shares one entry */
+	uint64_t seed = isStochastic() ? m_seed : 0;
+	return LSysCache::hash(&seed, sizeof(seed), key);
+}
+
+pje::engine::LSysGenerator::WordPrediction pje::engine::LSysGenerator::predictWord(uint8_t iterations) const {
+	return predict(m_axiom, iterations, !m_lEnvInput.empty());
+}
+
+pje::engine::LSysGenerator::WordPrediction pje::engine::LSysGenerator::predict(const std::string& word, uint8_t iterations, bool useContext) const {
+	const size_t	symbolCount = m_alphabet.size();
+	WordPrediction	prediction{ 0, {} };
+
+	if (isStochastic()) {
+		/* productions depend on the position of every symbol => counting pass over the whole word */
+		LSysStream stream(*this, word, iterations);
+		char symbol;
+		while (stream.next(symbol)) {
+			prediction.symbolCounts[static_cast<uint8_t>(symbol)]++;
+			prediction.length++;
+		}
+	}
+	else if (useContext) {
+		/* 1L: successors depend on their left context => counts are cached by the shared nodes of LSysDag */
+		LSysDag dag(*this, word, iterations);
+		for (const auto& symbol : m_alphabet)
+			prediction.symbolCounts[static_cast<uint8_t>(symbol)] = dag.getSymbolCount(symbol);
+		prediction.length = dag.getLength();
+	}
+	else {
+		/* 0L: growthMatrix[a * |alphabet| + b] := occurrences of b inside of successor(a) */
+		const RuleEntry*		row = contextFreeRow();
+		std::vector<uint64_t>	growthMatrix(symbolCount * symbolCount, 0);
+		for (size_t a = 0; a < symbolCount; a++) {
+			for (uint32_t i = 0; i < row[a].length; i++)
+				growthMatrix[a * symbolCount + m_successorIds[row[a].offset + i]]++;
+		}
+
+		std::vector<uint64_t> counts(symbolCount, 0);
+		for (const auto& symbol : word)
+			counts[m_symbolIds[static_cast<uint8_t>(symbol)]]++;
+
+		/* counts_(i+1) := counts_i * growthMatrix */
+		std::vector<uint64_t> nextCounts(symbolCount);
+		for (uint8_t i = 0; i < iterations; i++) {
+			std::fill(nextCounts.begin(), nextCounts.end(), 0);
+			for (size_t a = 0; a < symbolCount; a++) {
+				for (size_t b = 0; b < symbolCount; b++)
+					nextCounts[b] += counts[a] * growthMatrix[a * symbolCount + b];
+			}
+			counts.swap(nextCounts);
+		}
+
+		for (size_t id = 0; id < symbolCount; id++) {
+			prediction.symbolCounts[static_cast<uint8_t>(m_alphabet[id])] = counts[id];
+			prediction.length += counts[id];
 		}
 	}
+
+	return prediction;
 }
 
-void pje::engine::LSysGenerator::generate1LSysWord(std::string word, uint8_t iterations) {
-	/* clears member for next current iteration */
-	this->m_currentLSysWord.clear();
-	
-	/* recursion base */
-	if (iterations == 0) {
-		this->m_currentLSysWord.append(word);
+void pje::engine::LSysGenerator::reserveBuffers(const std::string& word, uint8_t iterations, bool useContext) {
+	/* stochastic prediction is a counting pass over the whole word => buffers grow per iteration instead */
+	if (iterations == 0 || isStochastic())
 		return;
+
+	/* every rewrite swaps both buffers => final word ends in the front buffer after an even number of swaps */
+	PackedWord& finalBuffer = iterations % 2 == 0 ? m_currentLSysWord : m_backBuffer;
+	PackedWord& priorBuffer = iterations % 2 == 0 ? m_backBuffer : m_currentLSysWord;
+
+	finalBuffer.reserve(predict(word, iterations, useContext).length);
+	priorBuffer.reserve(predict(word, iterations - 1, useContext).length);
+}
+
+std::unordered_map<std::string, std::vector<pje::engine::LSysProduction>> pje::engine::LSysGenerator::toProductions(const std::unordered_map<std::string, std::string>& rules) {
+	std::unordered_map<std::string, std::vector<LSysProduction>> productions;
+	for (const auto& rule : rules)
+		productions[rule.first] = { LSysProduction{ rule.second, 1.0f } };
+
+	return productions;
+}
+
+void pje::engine::LSysGenerator::compileRules() {
+	if (m_alphabet.empty() || m_alphabet.size() > 256)
+		throw std::runtime_error("LSysGenerator requires an alphabet of 1 to 256 characters.");
+
+	const size_t symbolCount = m_alphabet.size();
+
+	/* 1) alphabet => symbol ids */
+	std::array<bool, 256> isKnown{};
+	for (size_t id = 0; id < symbolCount; id++) {
+		if (isKnown[static_cast<uint8_t>(m_alphabet[id])])
+			throw std::runtime_error(std::string("L-System alphabet contains the character '") + m_alphabet[id] + "' more than once.");
+		m_symbolIds[static_cast<uint8_t>(m_alphabet[id])]	= static_cast<uint8_t>(id);
+		isKnown[static_cast<uint8_t>(m_alphabet[id])]		= true;
+	}
+	auto validate = [&isKnown](const std::string& characters) {
+		for (const auto& c : characters) {
+			if (!isKnown[static_cast<uint8_t>(c)])
+				throw std::runtime_error("L-System uses a character that is not part of its alphabet.");
+		}
+	};
+	validate(m_axiom);
+	validate(m_lEnvInput);
+
+	/* 2) identity successors: characters without defined rule persist in new word */
+	m_successorPool = m_alphabet;
+	m_choices.clear();
+	m_choiceThresholds.clear();
+	m_ruleTable.resize((symbolCount + 1) * symbolCount);
+	for (size_t row = 0; row <= symbolCount; row++) {
+		for (size_t id = 0; id < symbolCount; id++) {
+			m_ruleTable[row * symbolCount + id] = RuleEntry{ static_cast<uint32_t>(id), 1, 0, 0 };
+		}
+	}
+
+	/* only keys "<symbol>" or "<leftContext><symbol>" can be tabled */
+	for (const auto& rule : m_rules) {
+		if (rule.first.empty() || rule.first.size() > 2)
+			throw std::runtime_error("L-System rule key '" + rule.first + "' requires 1 or 2 characters.");
+	}
+
+	/* 3) rules with 1 character key (every context) before rules with 2 character key (override given context) */
+	for (size_t keySize = 1; keySize <= 2; keySize++) {
+		for (const auto& rule : m_rules) {
+			if (rule.first.size() != keySize)
+				continue;
+			if (rule.second.empty())
+				throw std::runtime_error("L-System rule requires at least 1 production.");
+			validate(rule.first);
+
+			/* every production => successor inside of m_successorPool */
+			float totalWeight = 0.0f;
+			std::vector<RuleEntry> productions;
+			for (const auto& production : rule.second) {
+				validate(production.successor);
+				if (!(production.weight > 0.0f))
+					throw std::runtime_error("L-System production requires a positive weight.");
+
+				productions.push_back(RuleEntry{ static_cast<uint32_t>(m_successorPool.size()), static_cast<uint32_t>(production.successor.size()), 0, 0 });
+				m_successorPool.append(production.successor);
+				totalWeight += production.weight;
+			}
+
+			RuleEntry entry = productions[0];
+			if (productions.size() > 1) {
+				/* stochastic: cumulative thresholds in [0, 2^32] | last threshold catches rounding */
+				entry.firstChoice	= static_cast<uint32_t>(m_choices.size());
+				entry.choiceCount	= static_cast<uint32_t>(productions.size());
+
+				double cumulativeWeight = 0.0;
+				for (size_t i = 0; i < productions.size(); i++) {
+					cumulativeWeight += rule.second[i].weight;
+					m_choices.push_back(productions[i]);
+					m_choiceThresholds.push_back(i + 1 == productions.size() ?
+						(uint64_t(1) << 32) :
+						static_cast<uint64_t>(cumulativeWeight / totalWeight * 4294967296.0)
+					);
+				}
+			}
+
+			uint8_t symbolId = m_symbolIds[static_cast<uint8_t>(rule.first.back())];
+			if (keySize == 1) {
+				for (size_t row = 0; row <= symbolCount; row++)
+					m_ruleTable[row * symbolCount + symbolId] = entry;
+			}
+			else {
+				m_ruleTable[m_symbolIds[static_cast<uint8_t>(rule.first.front())] * symbolCount + symbolId] = entry;
+			}
+		}
 	}
-	
-	/* first character + environmental input for rule lookup */
-	this->m_currentLSysWord.append(
-		this->m_rules.find(this->m_lEnvInput + word.at(0))->second
+
+	/* 4) successors as symbol ids */
+	m_successorIds.resize(m_successorPool.size());
+	for (size_t i = 0; i < m_successorPool.size(); i++)
+		m_successorIds[i] = m_symbolIds[static_cast<uint8_t>(m_successorPool[i])];
+}
+
+const pje::engine::LSysGenerator::RuleEntry* pje::engine::LSysGenerator::contextFreeRow() const {
+	return m_ruleTable.data() + m_alphabet.size() * m_alphabet.size();
+}
+
+void pje::engine::LSysGenerator::rewrite(bool useContext) {
+	auto		startTime	= std::chrono::steady_clock::now();
+	uint32_t	iteration	= static_cast<uint32_t>(m_iterationStats.size());
+
+	if (m_mode == DerivationMode::Parallel && m_currentLSysWord.size() >= PARALLEL_MIN_SYMBOLS) {
+		rewriteParallel(useContext, iteration);
+	}
+	else {
+		/* 1) counting pass: exact size of next word => back buffer is sized once per iteration */
+		m_backBuffer.resize(countSuccessors(m_currentLSysWord, 0, m_currentLSysWord.size(), useContext, iteration));
+		/* 2) writing pass */
+		PackedWord::Writer writer(m_backBuffer, 0);
+		writeSuccessors(m_currentLSysWord, 0, m_currentLSysWord.size(), useContext, iteration, writer);
+		writer.finish();
+	}
+
+	/* ping-pong: back buffer becomes new front buffer, old front buffer keeps its capacity for next step */
+	this->m_currentLSysWord.swap(this->m_backBuffer);
+
+	this->m_iterationStats.push_back(IterationStats{
+		m_currentLSysWord.size(),
+		static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count())
+	});
+}
+
+void pje::engine::LSysGenerator::rewriteParallel(bool useContext, uint32_t iteration) {
+	const PackedWord&	src			= m_currentLSysWord;
+	size_t				chunkCount	= std::max<size_t>(1, std::thread::hardware_concurrency()) * PARALLEL_CHUNKS_PER_CORE;
+	size_t				chunkSize	= (src.size() + chunkCount - 1) / chunkCount;
+
+	/* slices of the current word */
+	m_chunks.resize(chunkCount);
+	for (size_t i = 0; i < chunkCount; i++) {
+		m_chunks[i].srcBegin	= std::min(i * chunkSize, src.size());
+		m_chunks[i].srcEnd		= std::min(m_chunks[i].srcBegin + chunkSize, src.size());
+	}
+
+	/* 1) counting pass: expansion length of every slice */
+	std::for_each(
+		std::execution::par,
+		m_chunks.begin(),
+		m_chunks.end(),
+		[&](SymbolChunk& chunk) {
+			chunk.dstSize = countSuccessors(src, chunk.srcBegin, chunk.srcEnd, useContext, iteration);
+		}
 	);
 
-	/*
-	*	- populates string of 'current iteration' with remaining characters of 'word' in pairs of two characters
-	*	- appends rule.value || if (no rule was found) => appends current character
-	*/
-	for (std::string::size_type i = 1; i < word.size(); i++) {
-		auto pair = this->m_rules.find(word.substr(i-1, 2));
-		if (pair != this->m_rules.end()) {
-			this->m_currentLSysWord.append(pair->second);
+	/* 2) exclusive scan: output offset of every slice inside the next word */
+	size_t dstSize = 0;
+	for (auto& chunk : m_chunks) {
+		chunk.dstBegin	= dstSize;
+		dstSize			+= chunk.dstSize;
+	}
+	m_backBuffer.resize(dstSize);
+
+	/* 3) writing pass: every slice writes directly into its own range of the next word */
+	std::for_each(
+		std::execution::par,
+		m_chunks.begin(),
+		m_chunks.end(),
+		[&](SymbolChunk& chunk) {
+			PackedWord::Writer writer(m_backBuffer, chunk.dstBegin);
+			writeSuccessors(src, chunk.srcBegin, chunk.srcEnd, useContext, iteration, writer);
+			chunk.dstHead = writer.finish();
 		}
-		else {
-			this->m_currentLSysWord.append(1, word.at(i));
+	);
+
+	/* 4) blocks shared by neighbouring slices are merged after all slices were written */
+	for (const auto& chunk : m_chunks)
+		m_backBuffer.mergeHead(chunk.dstBegin, chunk.dstHead);
+}
+
+size_t pje::engine::LSysGenerator::countSuccessors(const PackedWord& src, size_t begin, size_t end, bool useContext, uint32_t iteration) const {
+	const size_t		symbolCount = m_alphabet.size();
+	const RuleEntry*	table		= m_ruleTable.data();
+	size_t				count		= 0;
+	size_t				position	= begin;
+
+	if (useContext) {
+		/* 1L: left context of first symbol is the environmental input */
+		size_t contextId = begin == 0 ? m_symbolIds[static_cast<uint8_t>(m_lEnvInput[0])] : src.getId(begin - 1);
+		src.forEachId(begin, end, [&](uint8_t symbolId) {
+			count += choose(table[contextId * symbolCount + symbolId], iteration, position++).length;
+			contextId = symbolId;
+		});
+	}
+	else {
+		const RuleEntry* row = contextFreeRow();
+		src.forEachId(begin, end, [&](uint8_t symbolId) {
+			count += choose(row[symbolId], iteration, position++).length;
+		});
+	}
+
+	return count;
+}
+
+void pje::engine::LSysGenerator::writeSuccessors(const PackedWord& src, size_t begin, size_t end, bool useContext, uint32_t iteration, PackedWord::Writer& out) const {
+	const size_t		symbolCount = m_alphabet.size();
+	const RuleEntry*	table		= m_ruleTable.data();
+	const uint8_t*		pool		= m_successorIds.data();
+	size_t				position	= begin;
+
+	/* appends successor of every symbol | identity successors cover symbols without defined rule */
+	if (useContext) {
+		size_t contextId = begin == 0 ? m_symbolIds[static_cast<uint8_t>(m_lEnvInput[0])] : src.getId(begin - 1);
+		src.forEachId(begin, end, [&](uint8_t symbolId) {
+			const RuleEntry& entry = choose(table[contextId * symbolCount + symbolId], iteration, position++);
+			out.put(pool + entry.offset, entry.length);
+			contextId = symbolId;
+		});
+	}
+	else {
+		const RuleEntry* row = contextFreeRow();
+		src.forEachId(begin, end, [&](uint8_t symbolId) {
+			const RuleEntry& entry = choose(row[symbolId], iteration, position++);
+			out.put(pool + entry.offset, entry.length);
+		});
+	}
+}
+
+/* ################################################################################### */
+
+pje::engine::LSysStream::LSysStream(const LSysGenerator& generator) : LSysStream(generator, generator.m_axiom, generator.m_iterations) {}
+
+pje::engine::LSysStream::LSysStream(const LSysGenerator& generator, const std::string& axiom, uint8_t iterations) : m_generator(generator), m_axiom(axiom), m_iterations(iterations), m_frames(), m_contextIds(), m_positions() {
+	reset();
+}
+
+pje::engine::LSysStream::~LSysStream() {}
+
+bool pje::engine::LSysStream::next(char& symbol) {
+	const size_t								symbolCount = m_generator.m_alphabet.size();
+	const LSysGenerator::RuleEntry*				table		= m_generator.m_ruleTable.data();
+	const LSysGenerator::RuleEntry*				row0L		= m_generator.contextFreeRow();
+	const char*									pool		= m_generator.m_successorPool.data();
+	const bool									useContext	= !m_generator.m_lEnvInput.empty();
+
+	while (!m_frames.empty()) {
+		Frame& frame = m_frames.back();
+
+		/* level is done => continue with the level above */
+		if (frame.cursor == frame.end) {
+			m_frames.pop_back();
+			continue;
 		}
+
+		char	current = *frame.cursor++;
+		size_t	level	= m_frames.size() - 1;
+
+		/* symbol of the final word */
+		if (level == m_iterations) {
+			symbol = current;
+			return true;
+		}
+
+		/* symbol of an intermediate word => descends into its successor | level := index of the rewrite */
+		uint8_t symbolId = m_generator.m_symbolIds[static_cast<uint8_t>(current)];
+		const LSysGenerator::RuleEntry& entry = m_generator.choose(
+			useContext ? table[m_contextIds[level] * symbolCount + symbolId] : row0L[symbolId],
+			static_cast<uint32_t>(level),
+			m_positions[level]++
+		);
+		m_contextIds[level] = symbolId;
+
+		m_frames.push_back(Frame{ pool + entry.offset, pool + entry.offset + entry.length });
 	}
 
-	/* recursion step */
-	generate1LSysWord(this->m_currentLSysWord, iterations-1);
+	return false;
 }
 
-std::string pje::engine::LSysGenerator::getCurrentLSysWord() const { return m_currentLSysWord; }
-std::string pje::engine::LSysGenerator::getAlphabet() const { return m_alphabet; }
\ No newline at end of file
+void pje::engine::LSysStream::reset() {
+	m_frames.clear();
+	m_frames.reserve(static_cast<size_t>(m_iterations) + 1);
+	m_frames.push_back(Frame{ m_axiom.data(), m_axiom.data() + m_axiom.size() });
+
+	/* first symbol of every level uses environmental input as its left context */
+	uint8_t envId = m_generator.m_lEnvInput.empty() ? 0 : m_generator.m_symbolIds[static_cast<uint8_t>(m_generator.m_lEnvInput[0])];
+	m_contextIds.assign(static_cast<size_t>(m_iterations) + 1, envId);
+	m_positions.assign(static_cast<size_t>(m_iterations) + 1, 0);
+}
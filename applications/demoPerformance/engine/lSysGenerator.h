@@ -3,32 +3,276 @@
 
 /* Third Party Files */
 	#include <cstdint>			// fixed size integer
+	#include <cstring>			// std::memcpy
 	#include <string>			// std::string
+	#include <array>			// std::array
+	#include <vector>			// std::vector
 	#include <unordered_map>	// hashtable
+	#include <chrono>			// (benchmark) time measurement
+	#include <thread>			// std::thread::hardware_concurrency
+	#include <algorithm>		// classic functions for ranges
+	#include <execution>		// parallel algorithms
+	#include <stdexcept>		// std::runtime_error
+
+/* Project Files */
+	#include "packedWord.h"
 
 namespace pje::engine {
 
+	class LSysStream;
+	class LSysDag;
+	class LSysCache;
+
+	/* LSysProduction - weighted alternative successor of a stochastic rule */
+	struct LSysProduction {
+		std::string	successor;
+		float		weight;			// relative probability among all productions of the same rule (> 0)
+	};
+
 	/* LSysGenerator - Generates a word where every character represents a command for the TurtleInterpreter */
 	class LSysGenerator {
 	public:
+		/* DerivationMode
+		*	- Sequential	: 1 core
+		*	- Parallel		: every core writes its own slice of the next word
+		*	- Streaming		: no word is stored => symbols are derived on demand via getStream()
+		*	- Dag			: no word is stored => every distinct sub-derivation is shared once via getDag()
+		*/
+		enum class DerivationMode { Sequential, Parallel, Streaming, Dag };
+
+		/* IterationStats - benchmark data of a single rewriting step */
+		struct IterationStats {
+			size_t		symbols;		// length of the word after this step
+			uint64_t	nanoseconds;	// duration of this step
+		};
+
+		/* WordPrediction - exact size of a word before it is generated */
+		struct WordPrediction {
+			uint64_t					length;
+			std::array<uint64_t, 256>	symbolCounts;	// [character] := occurrences inside of the word
+		};
+
 		LSysGenerator() = delete;
 		/* STANDARD CONSTRUCTOR
 		*	L-System := {Alphabet, Axiom, Rules}
 		*	>> [INFO]	Only supports 0L and 1L-Systems at the moment
 		*	>> [INFO]	Characters without defined rule will persist in new word
-		*	>> [INFO]	Generates first m_currentLSysWord automatically
+		*	>> [INFO]	Rules with 1 character key apply to every left context, rules with 2 character key to the given left context
+		*	>> [INFO]	Alphabet must contain every character of axiom, rules and envInput (max. 256 characters)
+		*	>> [INFO]	Generates first m_currentLSysWord automatically (except for DerivationMode::Streaming and DerivationMode::Dag)
+		*	>> [INFO]	Every DerivationMode produces the same words
 		*/
-		LSysGenerator(std::string alphabet, std::string axiom, std::unordered_map<std::string, std::string> rules, uint8_t iterations = 0, std::string envInput = "]");
+		LSysGenerator(
+			std::string alphabet, 
+			std::string axiom, 
+			std::unordered_map<std::string, std::string> rules, 
+			uint8_t iterations = 0, 
+			std::string envInput = "]", 
+			DerivationMode mode = DerivationMode::Sequential
+		);
+		/* STOCHASTIC CONSTRUCTOR
+		*	L-System := {Alphabet, Axiom, Rules with weighted productions}
+		*	>> [INFO]	Production of a symbol is chosen via hash(seed, iteration, position of symbol) => no RNG state
+		*	>> [INFO]	Same seed => same word in every DerivationMode except DerivationMode::Dag (requires deterministic rules)
+		*	>> [INFO]	cache (optional) => word is mapped from a prior launch or stored after its derivation (Sequential and Parallel only)
+		*/
+		LSysGenerator(
+			std::string alphabet, 
+			std::string axiom, 
+			std::unordered_map<std::string, std::vector<LSysProduction>> rules, 
+			uint8_t iterations = 0, 
+			std::string envInput = "]", 
+			DerivationMode mode = DerivationMode::Sequential,
+			uint64_t seed = 0,
+			const LSysCache* cache = nullptr
+		);
 		~LSysGenerator();
 		void generate0LSysWord(std::string axiom, uint8_t iterations);
 		void generate1LSysWord(std::string axiom, uint8_t iterations);
+		/* decodes m_currentLSysWord => prefer getPackedLSysWord() for large words */
 		std::string getCurrentLSysWord() const;
+		const PackedWord& getPackedLSysWord() const;
 		std::string getAlphabet() const;
+		std::string getAxiom() const;
+		uint8_t getIterations() const;
+		DerivationMode getDerivationMode() const;
+		/* seed for upcoming calls of generate0LSysWord(), generate1LSysWord(), getStream() and predictWord() */
+		void setSeed(uint64_t seed);
+		uint64_t getSeed() const;
+		/* true if any rule has more than 1 production */
+		bool isStochastic() const;
+		/* hash of alphabet, axiom, rules, envInput, getIterations() and (stochastic only) seed => key of LSysCache entries */
+		uint64_t getCacheKey() const;
+		/* depth-first cursor over the word of getIterations() iterations | memory: O(iterations) */
+		LSysStream getStream() const;
+		/* hash-consed derivation of the word of getIterations() iterations | include "lSysDag.h" to use it */
+		LSysDag getDag() const;
+		/* exact length and symbol counts of the axiom after iterations without generating the word
+		*	>> [INFO]	0L: counts of the axiom times the rule growth matrix per iteration
+		*	>> [INFO]	1L: counting pass over the shared nodes of a LSysDag
+		*	>> [INFO]	stochastic: counting pass over a LSysStream
+		*/
+		WordPrediction predictWord(uint8_t iterations) const;
+		/* per iteration stats of the latest call of generate0LSysWord() or generate1LSysWord() */
+		const std::vector<IterationStats>& getIterationStats() const;
 
 	private:
-		std::string m_currentLSysWord;
-		std::string m_alphabet;
-		std::unordered_map<std::string, std::string> m_rules;
-		std::string m_lEnvInput;
+		friend class LSysStream;
+		friend class LSysDag;
+
+		/* RuleEntry - successor of one (left context, symbol) pair inside m_successorPool */
+		struct RuleEntry {
+			uint32_t	offset;
+			uint32_t	length;
+			uint32_t	firstChoice;	// stochastic: productions m_choices[firstChoice, firstChoice + choiceCount)
+			uint32_t	choiceCount;	// 0 => deterministic
+		};
+
+		/* SymbolChunk - slice of the current word that is rewritten by one task in DerivationMode::Parallel */
+		struct SymbolChunk {
+			size_t		srcBegin;		// first symbol of this slice
+			size_t		srcEnd;			// symbol after last symbol of this slice
+			size_t		dstBegin;		// exclusive scan of dstSize => output offset in next word
+			size_t		dstSize;		// summed expansion length of all symbols of this slice
+			uint64_t	dstHead;		// bits of the first PackedWord block shared with the prior slice
+		};
+
+		DerivationMode				m_mode;
+		PackedWord					m_currentLSysWord;	// front buffer: word of the latest iteration
+		PackedWord					m_backBuffer;		// back buffer: word of the upcoming iteration
+		std::string					m_alphabet;
+		std::string					m_axiom;
+		uint8_t						m_iterations;
+		std::unordered_map<std::string, std::vector<LSysProduction>> m_rules;
+		uint64_t					m_seed;
+		std::string					m_lEnvInput;
+		std::vector<SymbolChunk>	m_chunks;			// reused slices for DerivationMode::Parallel
+		std::vector<IterationStats>	m_iterationStats;
+
+		/* compiled grammar => rule lookup is a single indexed load */
+		std::array<uint8_t, 256>	m_symbolIds;		// character -> symbol id := index inside m_alphabet
+		std::vector<RuleEntry>		m_ruleTable;		// [leftContextId * |alphabet| + symbolId] | last row => 0L (no context)
+		std::string					m_successorPool;	// successors of all RuleEntry(s) | starts with identity successors
+		std::vector<uint8_t>		m_successorIds;		// m_successorPool as symbol ids => written into PackedWord(s)
+		std::vector<RuleEntry>		m_choices;			// productions of stochastic RuleEntry(s)
+		std::vector<uint64_t>		m_choiceThresholds;	// cumulative weight of m_choices[i] scaled to 2^32
+
+		/* counter-based random number | same arguments => same number on every thread */
+		static inline uint64_t counterHash(uint64_t seed, uint64_t iteration, uint64_t position) {
+			auto mix = [](uint64_t z) {
+				/* splitmix64 finalizer */
+				z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+				z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+				return z ^ (z >> 31);
+			};
+			return mix(mix(seed ^ ((iteration + 1) * 0x9E3779B97F4A7C15ull)) ^ position);
+		}
+		/* production of entry for the symbol at position of the word of iteration */
+		inline const RuleEntry& choose(const RuleEntry& entry, uint32_t iteration, uint64_t position) const {
+			if (entry.choiceCount == 0)
+				return entry;
+
+			uint64_t	random	= counterHash(m_seed, iteration, position) >> 32;
+			uint32_t	choice	= entry.firstChoice;
+			while (random >= m_choiceThresholds[choice])
+				choice++;
+			return m_choices[choice];
+		}
+
+		/* deterministic rules => rules with a single production */
+		static std::unordered_map<std::string, std::vector<LSysProduction>> toProductions(const std::unordered_map<std::string, std::string>& rules);
+		/* maps m_alphabet to symbol ids and flattens m_rules into m_ruleTable */
+		void compileRules();
+		/* prediction for any word => sizes both buffers of generate0LSysWord() and generate1LSysWord() once */
+		WordPrediction predict(const std::string& word, uint8_t iterations, bool useContext) const;
+		/* reserves exact capacity for the last two words of the ping-pong derivation */
+		void reserveBuffers(const std::string& word, uint8_t iterations, bool useContext);
+		/* row of m_ruleTable for 0L lookups */
+		const RuleEntry* contextFreeRow() const;
+		/* rewrites m_currentLSysWord into m_backBuffer and swaps both buffers afterwards */
+		void rewrite(bool useContext);
+		/* splits m_currentLSysWord into slices and rewrites them concurrently into m_backBuffer */
+		void rewriteParallel(bool useContext, uint32_t iteration);
+		/* expansion length of the symbols [begin, end) of src | iteration := index of the rewrite that reads src */
+		size_t countSuccessors(const PackedWord& src, size_t begin, size_t end, bool useContext, uint32_t iteration) const;
+		/* writes expansion of the symbols [begin, end) of src to out */
+		void writeSuccessors(const PackedWord& src, size_t begin, size_t end, bool useContext, uint32_t iteration, PackedWord::Writer& out) const;
+	};
+
+	/* LSysStream - Expands the axiom of a LSysGenerator depth-first and yields the final word symbol by symbol */
+	class LSysStream {
+	public:
+		LSysStream() = delete;
+		/* derivation of generator's axiom after generator's iterations */
+		explicit LSysStream(const LSysGenerator& generator);
+		/* derivation of any word of generator's alphabet after iterations */
+		LSysStream(const LSysGenerator& generator, const std::string& axiom, uint8_t iterations);
+		/* m_frames point into m_axiom (SSO => inside of this object) => neither copyable nor movable | getStream() relies on guaranteed copy elision */
+		LSysStream(const LSysStream&) = delete;
+		LSysStream(LSysStream&&) = delete;
+		LSysStream& operator=(const LSysStream&) = delete;
+		LSysStream& operator=(LSysStream&&) = delete;
+		~LSysStream();
+
+		/* writes next symbol of the final word into symbol | returns false after last symbol */
+		bool next(char& symbol);
+		/* restarts at the first symbol of the final word */
+		void reset();
+
+		/* pushes every remaining symbol of the final word into consume(char symbol) => derivation and interpretation are fused
+		*	>> [INFO]	successors on the last level are handed over as a whole instead of 1 call of next() per symbol
+		*/
+		template <typename Consumer>
+		void forEach(Consumer&& consume) {
+			const size_t								symbolCount = m_generator.m_alphabet.size();
+			const LSysGenerator::RuleEntry*				table		= m_generator.m_ruleTable.data();
+			const LSysGenerator::RuleEntry*				row0L		= m_generator.contextFreeRow();
+			const char*									pool		= m_generator.m_successorPool.data();
+			const bool									useContext	= !m_generator.m_lEnvInput.empty();
+
+			while (!m_frames.empty()) {
+				Frame&	frame	= m_frames.back();
+				size_t	level	= m_frames.size() - 1;
+
+				/* symbols of the final word */
+				if (level == m_iterations) {
+					for (const char* symbol = frame.cursor; symbol != frame.end; symbol++)
+						consume(*symbol);
+					m_frames.pop_back();
+					continue;
+				}
+
+				/* level is done => continue with the level above */
+				if (frame.cursor == frame.end) {
+					m_frames.pop_back();
+					continue;
+				}
+
+				/* symbol of an intermediate word => descends into its successor | level := index of the rewrite */
+				uint8_t symbolId = m_generator.m_symbolIds[static_cast<uint8_t>(*frame.cursor++)];
+				const LSysGenerator::RuleEntry& entry = m_generator.choose(
+					useContext ? table[m_contextIds[level] * symbolCount + symbolId] : row0L[symbolId],
+					static_cast<uint32_t>(level),
+					m_positions[level]++
+				);
+				m_contextIds[level] = symbolId;
+
+				m_frames.push_back(Frame{ pool + entry.offset, pool + entry.offset + entry.length });
+			}
+		}
+
+	private:
+		/* Frame - remaining symbols of one derivation level (successor of a symbol of the level above) */
+		struct Frame {
+			const char* cursor;
+			const char* end;
+		};
+
+		const LSysGenerator&	m_generator;
+		std::string				m_axiom;
+		uint8_t					m_iterations;
+		std::vector<Frame>		m_frames;		// m_frames[level] | level == iterations => symbols of final word
+		std::vector<uint8_t>	m_contextIds;	// m_contextIds[level] := id of last symbol consumed on this level (1L context)
+		std::vector<uint64_t>	m_positions;	// m_positions[level] := symbols consumed on this level (stochastic rules)
 	};
-}
\ No newline at end of file
+}
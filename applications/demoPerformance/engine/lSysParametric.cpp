@@ -0,0 +1,409 @@
+#include "lSysParametric.h"
+
+pje::engine::LSysBytecode::LSysBytecode() : m_instructions() {}
+
+pje::engine::LSysBytecode::~LSysBytecode() {}
+
+pje::engine::LSysBytecode::Program pje::engine::LSysBytecode::compile(const std::string& expression, const std::vector<std::string>& formalParameters) {
+	Program program{ static_cast<uint32_t>(m_instructions.size()), 0 };
+
+	m_source			= expression;
+	m_cursor			= 0;
+	m_formalParameters	= &formalParameters;
+	m_stackDepth		= 0;
+
+	parseOr();
+
+	/* whole expression has to be consumed */
+	skipWhitespace();
+	if (m_cursor != m_source.size())
+		throw std::runtime_error("LSysBytecode can't parse expression: " + expression);
+
+	program.count = static_cast<uint32_t>(m_instructions.size()) - program.first;
+	return program;
+}
+
+uint32_t pje::engine::LSysBytecode::getInstructionCount() const { return static_cast<uint32_t>(m_instructions.size()); }
+
+void pje::engine::LSysBytecode::discard(uint32_t first) {
+	m_instructions.resize(first);
+}
+
+void pje::engine::LSysBytecode::parseOr() {
+	parseAnd();
+	while (accept("||")) {
+		parseAnd();
+		emit(OpCode::Or);
+	}
+}
+
+void pje::engine::LSysBytecode::parseAnd() {
+	parseComparison();
+	while (accept("&&")) {
+		parseComparison();
+		emit(OpCode::And);
+	}
+}
+
+void pje::engine::LSysBytecode::parseComparison() {
+	parseSum();
+
+	/* two character operators before their one character prefixes */
+	if		(accept("<="))	{ parseSum(); emit(OpCode::LessEqual); }
+	else if (accept(">="))	{ parseSum(); emit(OpCode::GreaterEqual); }
+	else if (accept("=="))	{ parseSum(); emit(OpCode::Equal); }
+	else if (accept("!="))	{ parseSum(); emit(OpCode::NotEqual); }
+	else if (accept("<"))	{ parseSum(); emit(OpCode::Less); }
+	else if (accept(">"))	{ parseSum(); emit(OpCode::Greater); }
+}
+
+void pje::engine::LSysBytecode::parseSum() {
+	parseProduct();
+	while (true) {
+		if		(accept("+"))	{ parseProduct(); emit(OpCode::Add); }
+		else if (accept("-"))	{ parseProduct(); emit(OpCode::Subtract); }
+		else					break;
+	}
+}
+
+void pje::engine::LSysBytecode::parseProduct() {
+	parseUnary();
+	while (true) {
+		if		(accept("*"))	{ parseUnary(); emit(OpCode::Multiply); }
+		else if (accept("/"))	{ parseUnary(); emit(OpCode::Divide); }
+		else					break;
+	}
+}
+
+void pje::engine::LSysBytecode::parseUnary() {
+	if (accept("-")) {
+		parseUnary();
+		emit(OpCode::Negate);
+	}
+	else if (accept("!")) {
+		parseUnary();
+		emit(OpCode::Not);
+	}
+	else {
+		parsePrimary();
+	}
+}
+
+void pje::engine::LSysBytecode::parsePrimary() {
+	skipWhitespace();
+	if (m_cursor == m_source.size())
+		throw std::runtime_error("LSysBytecode expected an operand at the end of: " + m_source);
+
+	if (accept("(")) {
+		parseOr();
+		if (!accept(")"))
+			throw std::runtime_error("LSysBytecode is missing ')' in: " + m_source);
+		return;
+	}
+
+	char current = m_source[m_cursor];
+
+	/* literal */
+	if (std::isdigit(static_cast<unsigned char>(current)) || current == '.') {
+		/* std::stof would throw std::invalid_argument / std::out_of_range for "." or "1e99" */
+		const char* begin	= m_source.c_str() + m_cursor;
+		char* end			= nullptr;
+		errno = 0;
+		float constant = std::strtof(begin, &end);
+		if (end == begin || errno == ERANGE)
+			throw std::runtime_error("LSysBytecode found invalid number at position " + std::to_string(m_cursor) + " in: " + m_source);
+
+		m_cursor += end - begin;
+		emit(OpCode::PushConstant, 0, constant);
+		return;
+	}
+
+	/* formal parameter */
+	if (std::isalpha(static_cast<unsigned char>(current)) || current == '_') {
+		size_t begin = m_cursor;
+		while (m_cursor < m_source.size() && (std::isalnum(static_cast<unsigned char>(m_source[m_cursor])) || m_source[m_cursor] == '_'))
+			m_cursor++;
+
+		std::string name = m_source.substr(begin, m_cursor - begin);
+		for (size_t i = 0; i < m_formalParameters->size(); i++) {
+			if ((*m_formalParameters)[i] == name) {
+				emit(OpCode::PushParameter, static_cast<uint8_t>(i));
+				return;
+			}
+		}
+		throw std::runtime_error("LSysBytecode found unknown parameter '" + name + "' in: " + m_source);
+	}
+
+	throw std::runtime_error("LSysBytecode found unexpected character in: " + m_source);
+}
+
+bool pje::engine::LSysBytecode::accept(const char* token) {
+	skipWhitespace();
+
+	size_t length = std::strlen(token);
+	if (m_source.compare(m_cursor, length, token) != 0)
+		return false;
+
+	m_cursor += length;
+	return true;
+}
+
+void pje::engine::LSysBytecode::skipWhitespace() {
+	while (m_cursor < m_source.size() && std::isspace(static_cast<unsigned char>(m_source[m_cursor])))
+		m_cursor++;
+}
+
+void pje::engine::LSysBytecode::emit(OpCode opCode, uint8_t parameter, float constant) {
+	/* stack depth after this instruction */
+	switch (opCode) {
+	case OpCode::PushConstant:
+	case OpCode::PushParameter:
+		if (++m_stackDepth > LSYS_BYTECODE_STACK_SIZE)
+			throw std::runtime_error("LSysBytecode expression is too deeply nested: " + m_source);
+		break;
+	case OpCode::Negate:
+	case OpCode::Not:
+		break;
+	default:
+		m_stackDepth--;
+	}
+
+	m_instructions.push_back(Instruction{ opCode, parameter, constant });
+}
+
+/* ################################################################################### */
+
+void pje::engine::LSysParametricWord::clear() {
+	modules.clear();
+	params.clear();
+}
+
+void pje::engine::LSysParametricWord::swap(LSysParametricWord& other) {
+	modules.swap(other.modules);
+	params.swap(other.params);
+}
+
+std::string pje::engine::LSysParametricWord::toString() const {
+	std::string word;
+	for (const auto& module : modules) {
+		word.push_back(module.symbol);
+		if (module.paramCount == 0)
+			continue;
+
+		word.push_back('(');
+		for (uint8_t i = 0; i < module.paramCount; i++) {
+			if (i != 0)
+				word.push_back(',');
+			std::string param = std::to_string(params[module.firstParam + i]);
+			/* trailing zeros of std::to_string */
+			param.erase(param.find_last_not_of('0') + 1);
+			if (param.back() == '.')
+				param.pop_back();
+			word.append(param);
+		}
+		word.push_back(')');
+	}
+	return word;
+}
+
+/* ################################################################################### */
+
+pje::engine::LSysParametricGenerator::LSysParametricGenerator(std::string alphabet,
+															  std::string axiom,
+															  std::vector<LSysParametricRule> rules,
+															  uint8_t iterations,
+															  std::string envInput) : m_alphabet(alphabet), m_axiom(axiom), m_envId(-1) {
+	if (alphabet.empty() || alphabet.size() > 256)
+		throw std::runtime_error("LSysParametricGenerator requires an alphabet of 1 to 256 characters.");
+
+	m_symbolIds.fill(-1);
+	for (size_t id = 0; id < alphabet.size(); id++)
+		m_symbolIds[static_cast<uint8_t>(alphabet[id])] = static_cast<int16_t>(id);
+
+	if (!envInput.empty()) {
+		m_envId = m_symbolIds[static_cast<uint8_t>(envInput[0])];
+		if (m_envId < 0)
+			throw std::runtime_error("L-System uses a character that is not part of its alphabet.");
+	}
+
+	/* context rules before context-free rules | declaration order otherwise */
+	std::vector<uint32_t> contextRules;
+	std::vector<uint32_t> contextFreeRules;
+	m_rulesBySymbol.resize(alphabet.size());
+
+	for (const auto& rule : rules) {
+		/* predecessor := [context]symbol[(formal, formal)] */
+		std::string				predecessor = rule.predecessor;
+		std::vector<std::string>	formalParameters;
+		predecessor.erase(std::remove_if(predecessor.begin(), predecessor.end(), [](char c) { return std::isspace(static_cast<unsigned char>(c)); }), predecessor.end());
+
+		size_t open = predecessor.find('(');
+		if (open != std::string::npos) {
+			if (predecessor.back() != ')')
+				throw std::runtime_error("LSysParametricRule has an invalid predecessor: " + rule.predecessor);
+
+			std::string list = predecessor.substr(open + 1, predecessor.size() - open - 2);
+			for (size_t begin = 0; begin <= list.size() && !list.empty(); ) {
+				size_t comma = list.find(',', begin);
+				formalParameters.push_back(list.substr(begin, comma == std::string::npos ? std::string::npos : comma - begin));
+				if (comma == std::string::npos)
+					break;
+				begin = comma + 1;
+			}
+			predecessor.erase(open);
+		}
+		if (predecessor.empty() || predecessor.size() > 2)
+			throw std::runtime_error("LSysParametricRule has an invalid predecessor: " + rule.predecessor);
+
+		for (const auto& c : predecessor) {
+			if (m_symbolIds[static_cast<uint8_t>(c)] < 0)
+				throw std::runtime_error("L-System uses a character that is not part of its alphabet.");
+		}
+
+		CompiledRule compiled{};
+		compiled.symbolId	= m_symbolIds[static_cast<uint8_t>(predecessor.back())];
+		compiled.contextId	= predecessor.size() == 2 ? m_symbolIds[static_cast<uint8_t>(predecessor.front())] : -1;
+		compiled.paramCount	= static_cast<uint8_t>(formalParameters.size());
+		compiled.condition	= rule.condition.empty() ? LSysBytecode::Program{ 0, 0 } : m_bytecode.compile(rule.condition, formalParameters);
+		compiled.firstModule = compileModules(rule.successor, formalParameters, compiled.moduleCount);
+
+		uint32_t ruleId = static_cast<uint32_t>(m_rules.size());
+		m_rules.push_back(compiled);
+		(compiled.contextId >= 0 ? contextRules : contextFreeRules).push_back(ruleId);
+	}
+
+	for (const auto& ruleIds : { contextRules, contextFreeRules }) {
+		for (const auto& ruleId : ruleIds)
+			m_rulesBySymbol[m_rules[ruleId].symbolId].push_back(ruleId);
+	}
+
+	generateWord(axiom, iterations);
+}
+
+pje::engine::LSysParametricGenerator::~LSysParametricGenerator() {}
+
+void pje::engine::LSysParametricGenerator::generateWord(const std::string& axiom, uint8_t iterations) {
+	/* axiom: modules with constant parameters | compiled temporarily on top of the rules */
+	uint32_t instructionCount	= m_bytecode.getInstructionCount();
+	size_t	 programCount		= m_programs.size();
+	uint32_t moduleCount		= 0;
+	uint32_t firstModule		= compileModules(axiom, {}, moduleCount);
+
+	m_currentWord.clear();
+	for (uint32_t i = firstModule; i < firstModule + moduleCount; i++) {
+		const ModuleTemplate& module = m_templates[i];
+		m_currentWord.modules.push_back(LSysModule{ module.symbol, module.paramCount, static_cast<uint32_t>(m_currentWord.params.size()) });
+		for (uint8_t p = 0; p < module.paramCount; p++)
+			m_currentWord.params.push_back(m_bytecode.run(m_programs[module.firstProgram + p], nullptr));
+	}
+	m_templates.resize(firstModule);
+	m_programs.resize(programCount);
+	m_bytecode.discard(instructionCount);
+	m_iterationStats.clear();
+
+	/* iterative derivation: every step rewrites front buffer into back buffer */
+	for (uint8_t i = 0; i < iterations; i++) {
+		rewrite();
+	}
+}
+
+const pje::engine::LSysParametricWord& pje::engine::LSysParametricGenerator::getCurrentWord() const { return m_currentWord; }
+std::string pje::engine::LSysParametricGenerator::getAlphabet() const { return m_alphabet; }
+std::string pje::engine::LSysParametricGenerator::getAxiom() const { return m_axiom; }
+const std::vector<pje::engine::LSysGenerator::IterationStats>& pje::engine::LSysParametricGenerator::getIterationStats() const { return m_iterationStats; }
+
+uint32_t pje::engine::LSysParametricGenerator::compileModules(const std::string& modules, const std::vector<std::string>& formalParameters, uint32_t& moduleCount) {
+	uint32_t firstModule = static_cast<uint32_t>(m_templates.size());
+
+	for (size_t i = 0; i < modules.size(); ) {
+		char symbol = modules[i++];
+		if (std::isspace(static_cast<unsigned char>(symbol)))
+			continue;
+		if (m_symbolIds[static_cast<uint8_t>(symbol)] < 0)
+			throw std::runtime_error("L-System uses a character that is not part of its alphabet.");
+
+		ModuleTemplate module{ symbol, 0, static_cast<uint32_t>(m_programs.size()) };
+
+		/* parameter list: expressions separated by top level commas */
+		if (i < modules.size() && modules[i] == '(') {
+			size_t	begin	= ++i;
+			int		depth	= 0;
+			for (; i < modules.size(); i++) {
+				char c = modules[i];
+				if (c == '(') {
+					depth++;
+				}
+				else if ((c == ',' && depth == 0) || (c == ')' && depth == 0)) {
+					m_programs.push_back(m_bytecode.compile(modules.substr(begin, i - begin), formalParameters));
+					module.paramCount++;
+					begin = i + 1;
+					if (c == ')')
+						break;
+				}
+				else if (c == ')') {
+					depth--;
+				}
+			}
+			if (i == modules.size())
+				throw std::runtime_error("L-System module is missing ')' in: " + modules);
+			i++;
+		}
+
+		m_templates.push_back(module);
+	}
+
+	moduleCount = static_cast<uint32_t>(m_templates.size()) - firstModule;
+	return firstModule;
+}
+
+void pje::engine::LSysParametricGenerator::rewrite() {
+	auto startTime = std::chrono::steady_clock::now();
+
+	const LSysParametricWord&	src = m_currentWord;
+	LSysParametricWord&			dst = m_backBuffer;
+	dst.clear();
+
+	int16_t contextId = m_envId;
+	for (const auto& module : src.modules) {
+		const float*		params	= src.params.data() + module.firstParam;
+		int16_t				symbolId = m_symbolIds[static_cast<uint8_t>(module.symbol)];
+		const CompiledRule*	applied	= nullptr;
+
+		/* first rule whose parameter count, context and condition match */
+		for (const auto& ruleId : m_rulesBySymbol[symbolId]) {
+			const CompiledRule& rule = m_rules[ruleId];
+			if (rule.paramCount != module.paramCount)
+				continue;
+			if (rule.contextId >= 0 && rule.contextId != contextId)
+				continue;
+			if (rule.condition.count != 0 && m_bytecode.run(rule.condition, params) == 0.0f)
+				continue;
+			applied = &rule;
+			break;
+		}
+
+		if (applied == nullptr) {
+			/* modules without matching rule persist in new word */
+			dst.modules.push_back(LSysModule{ module.symbol, module.paramCount, static_cast<uint32_t>(dst.params.size()) });
+			dst.params.insert(dst.params.end(), params, params + module.paramCount);
+		}
+		else {
+			for (uint32_t t = applied->firstModule; t < applied->firstModule + applied->moduleCount; t++) {
+				const ModuleTemplate& successor = m_templates[t];
+				dst.modules.push_back(LSysModule{ successor.symbol, successor.paramCount, static_cast<uint32_t>(dst.params.size()) });
+				for (uint8_t p = 0; p < successor.paramCount; p++)
+					dst.params.push_back(m_bytecode.run(m_programs[successor.firstProgram + p], params));
+			}
+		}
+
+		contextId = symbolId;
+	}
+
+	/* ping-pong: back buffer becomes new front buffer, old front buffer keeps its capacity for next step */
+	m_currentWord.swap(m_backBuffer);
+
+	m_iterationStats.push_back(LSysGenerator::IterationStats{
+		m_currentWord.modules.size(),
+		static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count())
+	});
+}
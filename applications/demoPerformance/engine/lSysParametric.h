@@ -0,0 +1,210 @@
+/* Ignores header if not needed after #include */
+	#pragma once
+
+/* Third Party Files */
+	#include <cstdint>			// fixed size integer
+	#include <cstring>			// std::strlen
+	#include <cstdlib>			// std::strtof
+	#include <cerrno>			// errno => ERANGE
+	#include <cctype>			// character classification
+	#include <string>			// std::string
+	#include <array>			// std::array
+	#include <vector>			// std::vector
+	#include <chrono>			// (benchmark) time measurement
+	#include <algorithm>		// std::remove_if
+	#include <stdexcept>		// std::runtime_error
+
+/* Project Files */
+	#include "lSysGenerator.h"
+
+#define LSYS_BYTECODE_STACK_SIZE	32	// max. operands on the stack of LSysBytecode::run()
+
+namespace pje::engine {
+
+	/* LSysBytecode - Compiles arithmetic and conditions of parametric rules for a stack machine
+	*	>> [INFO]	operators (lowest to highest precedence) : || && (< > <= >= == !=) (+ -) (* /) (unary - !)
+	*	>> [INFO]	operands : float literals, formal parameters of the predecessor, parentheses
+	*	>> [INFO]	booleans are 0.0f (false) and 1.0f (true)
+	*/
+	class LSysBytecode {
+	public:
+		enum class OpCode : uint8_t {
+			PushConstant, PushParameter,
+			Add, Subtract, Multiply, Divide, Negate, Not,
+			Less, Greater, LessEqual, GreaterEqual, Equal, NotEqual, And, Or
+		};
+
+		struct Instruction {
+			OpCode		opCode;
+			uint8_t		parameter;		// PushParameter: index of formal parameter
+			float		constant;		// PushConstant: literal
+		};
+
+		/* Program - m_instructions[first, first + count) */
+		struct Program {
+			uint32_t	first;
+			uint32_t	count;
+		};
+
+		LSysBytecode();
+		~LSysBytecode();
+
+		/* compiles expression over formalParameters | throws on syntax errors */
+		Program compile(const std::string& expression, const std::vector<std::string>& formalParameters);
+		uint32_t getInstructionCount() const;
+		/* removes every instruction from first on => programs compiled afterwards become invalid */
+		void discard(uint32_t first);
+
+		/* evaluates program with the actual parameters of a module */
+		inline float run(const Program& program, const float* parameters) const {
+			std::array<float, LSYS_BYTECODE_STACK_SIZE> stack;
+			size_t top = 0;
+
+			const Instruction* instruction	= m_instructions.data() + program.first;
+			const Instruction* end			= instruction + program.count;
+			for (; instruction != end; instruction++) {
+				switch (instruction->opCode) {
+				case OpCode::PushConstant:	stack[top++] = instruction->constant;					break;
+				case OpCode::PushParameter:	stack[top++] = parameters[instruction->parameter];		break;
+				case OpCode::Negate:		stack[top - 1] = -stack[top - 1];						break;
+				case OpCode::Not:			stack[top - 1] = stack[top - 1] == 0.0f ? 1.0f : 0.0f;	break;
+				default: {
+					float rhs = stack[--top];
+					float& lhs = stack[top - 1];
+					switch (instruction->opCode) {
+					case OpCode::Add:			lhs = lhs + rhs;							break;
+					case OpCode::Subtract:		lhs = lhs - rhs;							break;
+					case OpCode::Multiply:		lhs = lhs * rhs;							break;
+					case OpCode::Divide:		lhs = lhs / rhs;							break;
+					case OpCode::Less:			lhs = lhs < rhs ? 1.0f : 0.0f;				break;
+					case OpCode::Greater:		lhs = lhs > rhs ? 1.0f : 0.0f;				break;
+					case OpCode::LessEqual:		lhs = lhs <= rhs ? 1.0f : 0.0f;				break;
+					case OpCode::GreaterEqual:	lhs = lhs >= rhs ? 1.0f : 0.0f;				break;
+					case OpCode::Equal:			lhs = lhs == rhs ? 1.0f : 0.0f;				break;
+					case OpCode::NotEqual:		lhs = lhs != rhs ? 1.0f : 0.0f;				break;
+					case OpCode::And:			lhs = (lhs != 0.0f && rhs != 0.0f) ? 1.0f : 0.0f;	break;
+					case OpCode::Or:			lhs = (lhs != 0.0f || rhs != 0.0f) ? 1.0f : 0.0f;	break;
+					default:																break;
+					}
+				}
+				}
+			}
+
+			return stack[0];
+		}
+
+	private:
+		std::vector<Instruction>	m_instructions;
+
+		/* compile helpers: recursive descent over m_source */
+		std::string					m_source;
+		size_t						m_cursor = 0;
+		const std::vector<std::string>* m_formalParameters = nullptr;
+		size_t						m_stackDepth = 0;
+
+		void parseOr();
+		void parseAnd();
+		void parseComparison();
+		void parseSum();
+		void parseProduct();
+		void parseUnary();
+		void parsePrimary();
+		/* consumes token if it follows (after whitespace) */
+		bool accept(const char* token);
+		void skipWhitespace();
+		void emit(OpCode opCode, uint8_t parameter = 0, float constant = 0.0f);
+	};
+
+	/* LSysParametricRule - predecessor : condition -> successor
+	*	>> [INFO]	predecessor := "S(l)" or with left context "]S(l)" (context is matched by its symbol only)
+	*	>> [INFO]	condition	:= "" (always) or expression like "l > 0.1 && l < 2"
+	*	>> [INFO]	successor	:= modules with expressions like "S(l*0.8)[+(30)L(1)]"
+	*/
+	struct LSysParametricRule {
+		std::string predecessor;
+		std::string condition;
+		std::string successor;
+	};
+
+	/* LSysModule - symbol with parameters LSysParametricWord::params[firstParam, firstParam + paramCount) */
+	struct LSysModule {
+		char		symbol;
+		uint8_t		paramCount;
+		uint32_t	firstParam;
+	};
+
+	/* LSysParametricWord - word of modules | parameters of all modules share one pool */
+	struct LSysParametricWord {
+		std::vector<LSysModule>	modules;
+		std::vector<float>		params;
+
+		void clear();
+		void swap(LSysParametricWord& other);
+		std::string toString() const;
+	};
+
+	/* LSysParametricGenerator - Generates a word of parametric modules for the TurtleInterpreter */
+	class LSysParametricGenerator {
+	public:
+		LSysParametricGenerator() = delete;
+		/* STANDARD CONSTRUCTOR
+		*	Parametric L-System := {Alphabet, Axiom, Rules}
+		*	>> [INFO]	Axiom uses constant parameters only, e.g. "S(0.2)"
+		*	>> [INFO]	First rule (context rules before context-free rules) whose symbol, parameter count, context and condition match is applied
+		*	>> [INFO]	Modules without matching rule persist in new word
+		*	>> [INFO]	envInput := left context of the first module (empty => context rules never match it)
+		*/
+		LSysParametricGenerator(
+			std::string alphabet,
+			std::string axiom,
+			std::vector<LSysParametricRule> rules,
+			uint8_t iterations = 0,
+			std::string envInput = "]"
+		);
+		~LSysParametricGenerator();
+
+		void generateWord(const std::string& axiom, uint8_t iterations);
+		const LSysParametricWord& getCurrentWord() const;
+		std::string getAlphabet() const;
+		std::string getAxiom() const;
+		const std::vector<LSysGenerator::IterationStats>& getIterationStats() const;
+
+	private:
+		/* ModuleTemplate - module of a successor | parameters := m_programs[firstProgram, firstProgram + paramCount) */
+		struct ModuleTemplate {
+			char		symbol;
+			uint8_t		paramCount;
+			uint32_t	firstProgram;
+		};
+
+		/* CompiledRule - successor := m_templates[firstModule, firstModule + moduleCount) */
+		struct CompiledRule {
+			int16_t					symbolId;
+			int16_t					contextId;		// -1 => every context
+			uint8_t					paramCount;		// formal parameters of predecessor
+			LSysBytecode::Program	condition;		// count == 0 => always
+			uint32_t				firstModule;
+			uint32_t				moduleCount;
+		};
+
+		std::string						m_alphabet;
+		std::string						m_axiom;
+		int16_t							m_envId;			// -1 => no environmental input
+		std::array<int16_t, 256>		m_symbolIds;		// character -> symbol id | -1 => not part of alphabet
+
+		LSysBytecode					m_bytecode;
+		std::vector<LSysBytecode::Program>	m_programs;
+		std::vector<ModuleTemplate>		m_templates;
+		std::vector<CompiledRule>		m_rules;
+		std::vector<std::vector<uint32_t>>	m_rulesBySymbol;	// [symbolId] := ids of m_rules in matching order
+
+		LSysParametricWord				m_currentWord;		// front buffer: word of the latest iteration
+		LSysParametricWord				m_backBuffer;		// back buffer: word of the upcoming iteration
+		std::vector<LSysGenerator::IterationStats> m_iterationStats;
+
+		/* parses "S(expr, expr)[+(expr)L]" into m_templates | returns first template */
+		uint32_t compileModules(const std::string& modules, const std::vector<std::string>& formalParameters, uint32_t& moduleCount);
+		/* rewrites m_currentWord into m_backBuffer and swaps both buffers afterwards */
+		void rewrite();
+	};
+}
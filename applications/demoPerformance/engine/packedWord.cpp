@@ -0,0 +1,164 @@
+#include "packedWord.h"
+
+pje::engine::PackedWord::Writer::Writer(PackedWord& word, size_t begin) : m_blocks(word.m_blocks.data()), m_block(0), m_head(0) {
+	m_bitWidth		= word.m_bitWidth;
+	m_blockBits		= word.m_symbolsPerBlock * word.m_bitWidth;
+	m_blockIndex	= begin / word.m_symbolsPerBlock;
+	m_shift			= static_cast<uint32_t>(begin % word.m_symbolsPerBlock) * m_bitWidth;
+	m_headIndex		= m_shift != 0 ? m_blockIndex : SIZE_MAX;
+}
+
+pje::engine::PackedWord::Writer::~Writer() {}
+
+uint64_t pje::engine::PackedWord::Writer::finish() {
+	if (m_shift != 0)
+		store();
+
+	return m_head;
+}
+
+void pje::engine::PackedWord::Writer::store() {
+	/* shared first block is merged afterwards => no concurrent write to the same block */
+	if (m_blockIndex == m_headIndex)
+		m_head = m_block;
+	else
+		m_blocks[m_blockIndex] = m_block;
+
+	m_blockIndex++;
+	m_block = 0;
+	m_shift = 0;
+}
+
+/* ################################################################################### */
+
+pje::engine::PackedWord::PackedWord(const std::string& alphabet) : m_alphabet(alphabet), m_size(0), m_blocks() {
+	if (alphabet.size() > 256)
+		throw std::runtime_error("PackedWord supports alphabets of max. 256 characters.");
+
+	m_symbolIds.fill(-1);
+	for (size_t id = 0; id < alphabet.size(); id++)
+		m_symbolIds[static_cast<uint8_t>(alphabet[id])] = static_cast<int16_t>(id);
+
+	/* minimum bit width that can address every symbol id */
+	m_bitWidth = 1;
+	while ((size_t(1) << m_bitWidth) < alphabet.size())
+		m_bitWidth++;
+
+	m_symbolsPerBlock	= 64 / m_bitWidth;
+	m_mask				= (uint64_t(1) << m_bitWidth) - 1;
+}
+
+pje::engine::PackedWord::~PackedWord() {}
+
+size_t pje::engine::PackedWord::byteSizeOf(uint64_t symbols, size_t alphabetSize) {
+	uint32_t bitWidth = 1;
+	while ((size_t(1) << bitWidth) < alphabetSize)
+		bitWidth++;
+
+	uint64_t symbolsPerBlock = 64 / bitWidth;
+	return static_cast<size_t>((symbols + symbolsPerBlock - 1) / symbolsPerBlock * sizeof(uint64_t));
+}
+
+size_t pje::engine::PackedWord::size() const { return m_size; }
+bool pje::engine::PackedWord::empty() const { return m_size == 0; }
+size_t pje::engine::PackedWord::byteSize() const { return m_blocks.size() * sizeof(uint64_t); }
+uint8_t pje::engine::PackedWord::getBitWidth() const { return static_cast<uint8_t>(m_bitWidth); }
+const std::string& pje::engine::PackedWord::getAlphabet() const { return m_alphabet; }
+const uint64_t* pje::engine::PackedWord::data() const { return m_blocks.data(); }
+
+void pje::engine::PackedWord::clear() {
+	m_size = 0;
+	m_blocks.clear();
+}
+
+void pje::engine::PackedWord::reserve(size_t symbols) {
+	m_blocks.reserve((symbols + m_symbolsPerBlock - 1) / m_symbolsPerBlock);
+}
+
+void pje::engine::PackedWord::resize(size_t symbols) {
+	m_blocks.resize((symbols + m_symbolsPerBlock - 1) / m_symbolsPerBlock);
+
+	/* shrinking: clears removed symbols of the last block => later appends can OR into it */
+	if (symbols < m_size && symbols % m_symbolsPerBlock != 0)
+		m_blocks.back() &= (uint64_t(1) << ((symbols % m_symbolsPerBlock) * m_bitWidth)) - 1;
+
+	m_size = symbols;
+}
+
+void pje::engine::PackedWord::swap(PackedWord& other) {
+	m_alphabet.swap(other.m_alphabet);
+	std::swap(m_symbolIds, other.m_symbolIds);
+	std::swap(m_bitWidth, other.m_bitWidth);
+	std::swap(m_symbolsPerBlock, other.m_symbolsPerBlock);
+	std::swap(m_mask, other.m_mask);
+	std::swap(m_size, other.m_size);
+	m_blocks.swap(other.m_blocks);
+}
+
+void pje::engine::PackedWord::assign(const std::string& word) {
+	std::vector<uint8_t> ids(word.size());
+	for (size_t i = 0; i < word.size(); i++) {
+		int16_t id = m_symbolIds[static_cast<uint8_t>(word[i])];
+		if (id < 0)
+			throw std::runtime_error("PackedWord received a character that is not part of its alphabet.");
+		ids[i] = static_cast<uint8_t>(id);
+	}
+
+	clear();
+	append(ids.data(), ids.size());
+}
+
+void pje::engine::PackedWord::assignBlocks(const uint64_t* blocks, size_t symbols) {
+	m_size = symbols;
+	m_blocks.assign(blocks, blocks + (symbols + m_symbolsPerBlock - 1) / m_symbolsPerBlock);
+}
+
+void pje::engine::PackedWord::append(const uint8_t* ids, size_t count) {
+	size_t begin = m_size;
+	resize(m_size + count);
+
+	/* last block of the old word is shared with the writer => merged afterwards */
+	Writer writer(*this, begin);
+	writer.put(ids, count);
+	mergeHead(begin, writer.finish());
+}
+
+void pje::engine::PackedWord::pushBack(uint8_t id) {
+	append(&id, 1);
+}
+
+void pje::engine::PackedWord::mergeHead(size_t begin, uint64_t head) {
+	if (begin % m_symbolsPerBlock != 0)
+		m_blocks[begin / m_symbolsPerBlock] |= head;
+}
+
+uint8_t pje::engine::PackedWord::getId(size_t index) const {
+	return static_cast<uint8_t>((m_blocks[index / m_symbolsPerBlock] >> ((index % m_symbolsPerBlock) * m_bitWidth)) & m_mask);
+}
+
+char pje::engine::PackedWord::at(size_t index) const {
+	return m_alphabet[getId(index)];
+}
+
+size_t pje::engine::PackedWord::commonPrefix(const PackedWord& other) const {
+	if (m_alphabet != other.m_alphabet)
+		return 0;
+
+	const size_t symbols = std::min(m_size, other.m_size);
+	size_t i = 0;
+
+	/* whole blocks first => symbols are only decoded from the first differing block on */
+	while (i + m_symbolsPerBlock <= symbols && m_blocks[i / m_symbolsPerBlock] == other.m_blocks[i / m_symbolsPerBlock])
+		i += m_symbolsPerBlock;
+	while (i < symbols && getId(i) == other.getId(i))
+		i++;
+
+	return i;
+}
+
+std::string pje::engine::PackedWord::toString() const {
+	std::string word;
+	word.reserve(m_size);
+	forEachSymbol([&word](char symbol) { word.push_back(symbol); });
+	return word;
+}
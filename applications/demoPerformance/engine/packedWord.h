@@ -0,0 +1,136 @@
+/* Ignores header if not needed after #include */
+	#pragma once
+
+/* Third Party Files */
+	#include <cstdint>			// fixed size integer
+	#include <string>			// std::string
+	#include <array>			// std::array
+	#include <vector>			// std::vector
+	#include <algorithm>		// std::min
+	#include <stdexcept>		// std::runtime_error
+
+namespace pje::engine {
+
+	/* PackedWord - Stores symbol ids of an alphabet with minimum bit width inside 64 bit blocks
+	*	>> [INFO]	bitWidth := ceil(log2(|alphabet|)) => 7 symbols need 3 bits (21 symbols per block)
+	*	>> [INFO]	symbols never cross a block boundary => symbol i lives in block i / symbolsPerBlock
+	*/
+	class PackedWord {
+	public:
+		/* Writer - Appends symbol ids sequentially to a preallocated range [begin, ...) of a PackedWord
+		*	>> [INFO]	blocks starting inside the range are owned and stored by this writer
+		*	>> [INFO]	a first block shared with the prior range is returned by finish() => merge it via mergeHead()
+		*	>> [INFO]	allows concurrent writers on disjoint ranges of the same PackedWord
+		*/
+		class Writer {
+		public:
+			Writer() = delete;
+			Writer(PackedWord& word, size_t begin);
+			~Writer();
+
+			inline void put(uint8_t id) {
+				m_block |= static_cast<uint64_t>(id) << m_shift;
+				m_shift += m_bitWidth;
+				if (m_shift == m_blockBits)
+					store();
+			}
+			inline void put(const uint8_t* ids, size_t count) {
+				for (size_t i = 0; i < count; i++)
+					put(ids[i]);
+			}
+			/* stores last partial block | returns bits of the shared first block (0 if range starts at a block boundary) */
+			uint64_t finish();
+
+		private:
+			uint64_t*	m_blocks;
+			size_t		m_blockIndex;		// block that is currently assembled in m_block
+			size_t		m_headIndex;		// shared first block | SIZE_MAX if range starts at a block boundary
+			uint64_t	m_block;
+			uint64_t	m_head;
+			uint32_t	m_shift;
+			uint32_t	m_bitWidth;
+			uint32_t	m_blockBits;		// symbolsPerBlock * bitWidth
+
+			void store();
+		};
+
+		PackedWord() = delete;
+		/* STANDARD CONSTRUCTOR
+		*	>> [INFO]	alphabet maps symbol id => character (max. 256 characters)
+		*/
+		explicit PackedWord(const std::string& alphabet);
+		~PackedWord();
+
+		/* bytes needed for symbols of an alphabet with alphabetSize characters */
+		static size_t byteSizeOf(uint64_t symbols, size_t alphabetSize);
+
+		size_t size() const;
+		bool empty() const;
+		/* allocated bytes for size() symbols */
+		size_t byteSize() const;
+		uint8_t getBitWidth() const;
+		const std::string& getAlphabet() const;
+		/* byteSize() bytes of 64 bit blocks */
+		const uint64_t* data() const;
+
+		void clear();
+		void reserve(size_t symbols);
+		/* new symbols are undefined until they are written by a Writer */
+		void resize(size_t symbols);
+		void swap(PackedWord& other);
+		/* encodes every character of word | throws if a character is not part of the alphabet */
+		void assign(const std::string& word);
+		/* copies already packed blocks of symbols (same bit width) => e.g. a word mapped from LSysCache */
+		void assignBlocks(const uint64_t* blocks, size_t symbols);
+		void append(const uint8_t* ids, size_t count);
+		void pushBack(uint8_t id);
+		/* ORs head (see Writer::finish) into the block of begin */
+		void mergeHead(size_t begin, uint64_t head);
+
+		uint8_t getId(size_t index) const;
+		char at(size_t index) const;
+		/* symbols shared by the beginning of this word and other | different alphabets => 0 */
+		size_t commonPrefix(const PackedWord& other) const;
+		/* decodes every symbol => only for small words or debugging */
+		std::string toString() const;
+
+		/* calls f(uint8_t id) for every symbol of [begin, end) */
+		template <typename Function>
+		void forEachId(size_t begin, size_t end, Function&& f) const {
+			if (begin >= end)
+				return;
+
+			size_t		block	= begin / m_symbolsPerBlock;
+			size_t		inBlock	= m_symbolsPerBlock - begin % m_symbolsPerBlock;
+			uint64_t	bits	= m_blocks[block] >> ((begin % m_symbolsPerBlock) * m_bitWidth);
+
+			for (size_t i = begin; i < end; ) {
+				size_t n = std::min(inBlock, end - i);
+				for (size_t k = 0; k < n; k++) {
+					f(static_cast<uint8_t>(bits & m_mask));
+					bits >>= m_bitWidth;
+				}
+				i += n;
+				if (i < end)
+					bits = m_blocks[++block];
+				inBlock = m_symbolsPerBlock;
+			}
+		}
+
+		/* calls f(char symbol) for every symbol of the word without unpacking it */
+		template <typename Function>
+		void forEachSymbol(Function&& f) const {
+			const char* alphabet = m_alphabet.data();
+			forEachId(0, m_size, [&](uint8_t id) { f(alphabet[id]); });
+		}
+
+	private:
+		std::string					m_alphabet;
+		std::array<int16_t, 256>	m_symbolIds;		// character -> symbol id | -1 => not part of alphabet
+		uint32_t					m_bitWidth;
+		uint32_t					m_symbolsPerBlock;
+		uint64_t					m_mask;
+		size_t						m_size;
+		std::vector<uint64_t>		m_blocks;
+	};
+}
@@ -1,4 +1,5 @@
 #include "pjeBuffers.h"
+#include "boneKernel.h"
 
 pje::engine::types::Vertex::Vertex(glm::vec3 pos, glm::vec3 normal, glm::vec2 uv, glm::uvec2 boneAttrib) : 
 	m_pos(pos), m_normal(normal), m_uv(uv), m_boneAttrib(boneAttrib) {}
@@ -41,6 +42,86 @@ VkVertexInputBindingDescription pje::engine::types::Vertex::getVulkanBindingDesc
 
 /* ################################################################################### */
 
+pje::engine::types::CompactVertex::CompactVertex(const Vertex& vertex, const VertexDecode& decode) {
+	/* position => unorm16 inside of AABB | flat axis => 0 */
+	for (int axis = 0; axis < 3; axis++) {
+		const float unorm = decode.positionExtent[axis] > 0.0f ? (vertex.m_pos[axis] - decode.positionMin[axis]) / decode.positionExtent[axis] : 0.0f;
+		m_pos[axis] = static_cast<uint16_t>(std::round(std::clamp(unorm, 0.0f, 1.0f) * 65535.0f));
+	}
+	m_pos[3] = 0;
+
+	/* normal => octahedron |x| + |y| + |z| = 1 => lower half is folded onto the upper one | zero normal (degenerate or missing) => (0, 0, 1) instead of NaN */
+	const float l1 = std::abs(vertex.m_normal.x) + std::abs(vertex.m_normal.y) + std::abs(vertex.m_normal.z);
+	const glm::vec3 n = l1 > std::numeric_limits<float>::epsilon() ? vertex.m_normal / l1 : glm::vec3(0.0f, 0.0f, 1.0f);
+	glm::vec2 octahedral(n.x, n.y);
+	if (n.z < 0.0f) {
+		octahedral.x = (1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f);
+		octahedral.y = (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f);
+	}
+	for (int axis = 0; axis < 2; axis++)
+		m_normal[axis] = static_cast<int16_t>(std::round(std::clamp(octahedral[axis], -1.0f, 1.0f) * 32767.0f));
+
+	/* uv => half float | repeated textures may exceed [0, 1] */
+	m_uv = glm::u16vec2(glm::packHalf1x16(vertex.m_uv.x), glm::packHalf1x16(vertex.m_uv.y));
+
+	m_boneAttrib = glm::u16vec2(vertex.m_boneAttrib.x - decode.boneRefBase, vertex.m_boneAttrib.y);
+}
+
+pje::engine::types::Vertex pje::engine::types::CompactVertex::decode(const VertexDecode& decode) const {
+	glm::vec3 pos;
+	for (int axis = 0; axis < 3; axis++)
+		pos[axis] = decode.positionMin[axis] + (m_pos[axis] / 65535.0f) * decode.positionExtent[axis];
+
+	glm::vec3 n(std::max(m_normal[0] / 32767.0f, -1.0f), std::max(m_normal[1] / 32767.0f, -1.0f), 0.0f);
+	n.z = 1.0f - std::abs(n.x) - std::abs(n.y);
+	const float fold = std::max(-n.z, 0.0f);
+	n.x += n.x >= 0.0f ? -fold : fold;
+	n.y += n.y >= 0.0f ? -fold : fold;
+
+	return Vertex(
+		pos,
+		glm::normalize(n),
+		glm::vec2(glm::unpackHalf1x16(m_uv[0]), glm::unpackHalf1x16(m_uv[1])),
+		glm::uvec2(m_boneAttrib[0] + decode.boneRefBase, m_boneAttrib[1])
+	);
+}
+
+std::array<VkVertexInputAttributeDescription, 4> pje::engine::types::CompactVertex::getVulkanAttribDesc() {
+	std::array<VkVertexInputAttributeDescription, 4> desc;
+
+	desc[0].location	= 0;										// layout(location = 0)
+	desc[0].binding		= 0;
+	desc[0].format		= VkFormat::VK_FORMAT_R16G16B16A16_UNORM;	// vec3 pos (w ignored)
+	desc[0].offset		= offsetof(CompactVertex, m_pos);			// 0
+
+	desc[1].location	= 1;										// layout(location = 1)
+	desc[1].binding		= 0;
+	desc[1].format		= VkFormat::VK_FORMAT_R16G16_SNORM;			// vec3 normal => xy := octahedral
+	desc[1].offset		= offsetof(CompactVertex, m_normal);		// 4 * 2 Byte = 8
+
+	desc[2].location	= 2;										// layout(location = 2)
+	desc[2].binding		= 0;
+	desc[2].format		= VkFormat::VK_FORMAT_R16G16_SFLOAT;		// vec2 uv
+	desc[2].offset		= offsetof(CompactVertex, m_uv);			// 6 * 2 Byte = 12
+
+	desc[3].location	= 3;										// layout(location = 3)
+	desc[3].binding		= 0;
+	desc[3].format		= VkFormat::VK_FORMAT_R16G16_UINT;			// uvec2 boneAttrib
+	desc[3].offset		= offsetof(CompactVertex, m_boneAttrib);	// 8 * 2 Byte = 16
+
+	return desc;
+}
+
+VkVertexInputBindingDescription pje::engine::types::CompactVertex::getVulkanBindingDesc() {
+	VkVertexInputBindingDescription desc;
+	desc.binding	= 0;
+	desc.stride		= sizeof(CompactVertex);
+	desc.inputRate	= VkVertexInputRate::VK_VERTEX_INPUT_RATE_VERTEX;
+	return desc;
+}
+
+/* ################################################################################### */
+
 pje::engine::types::Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, uint32_t offsetVertices, uint32_t offsetIndices) : 
 	m_vertices(vertices), m_indices(indices), m_offsetPriorMeshesVertices(offsetVertices), m_offsetPriorMeshesIndices(offsetIndices) {}
 
@@ -54,16 +135,408 @@ pje::engine::types::Primitive::~Primitive() {}
 
 /* ################################################################################### */
 
-pje::engine::types::LSysPrimitive::LSysPrimitive() : Primitive() {}
+pje::engine::types::RigidTransform pje::engine::types::RigidTransform::operator*(const RigidTransform& local) const {
+	return RigidTransform{ rotation * local.rotation, translation + rotation * local.translation };
+}
 
-pje::engine::types::LSysPrimitive::~LSysPrimitive() {}
+pje::engine::types::RigidTransform pje::engine::types::RigidTransform::translated(const glm::vec3& localTranslation) const {
+	return RigidTransform{ rotation, translation + rotation * localTranslation };
+}
+
+pje::engine::types::RigidTransform pje::engine::types::RigidTransform::rotated(const glm::quat& localRotation) const {
+	return RigidTransform{ glm::normalize(rotation * localRotation), translation };
+}
+
+pje::engine::types::RigidTransform pje::engine::types::RigidTransform::inverse() const {
+	/* (T * R)^-1 = R^-1 * T^-1 | R^-1 := conjugate of unit quaternion */
+	const glm::quat inverseRotation = glm::conjugate(rotation);
+	return RigidTransform{ inverseRotation, -(inverseRotation * translation) };
+}
+
+glm::mat4 pje::engine::types::RigidTransform::toMat4() const {
+	glm::mat4 mat = glm::mat4_cast(rotation);
+	mat[3] = glm::vec4(translation, 1.0f);
+	return mat;
+}
+
+/* ################################################################################### */
+
+void pje::engine::types::BoneRestFrames::assign(const std::vector<Bone>& bones) {
+	for (auto* component : { &axisX, &axisY, &axisZ, &originX, &originY, &originZ })
+		component->resize(bones.size());
+	parent.resize(bones.size());
+
+	for (size_t bone = 0; bone < bones.size(); bone++) {
+		const glm::vec3 axis = bones[bone].restpose.rotation * glm::vec3(0.0f, 0.0f, 1.0f);
+		axisX[bone]		= axis.x;
+		axisY[bone]		= axis.y;
+		axisZ[bone]		= axis.z;
+		originX[bone]	= bones[bone].restpose.translation.x;
+		originY[bone]	= bones[bone].restpose.translation.y;
+		originZ[bone]	= bones[bone].restpose.translation.z;
+		parent[bone]	= bones[bone].parent;
+	}
+
+	/* bones on the chain of every bone: pre-order => parent first */
+	std::vector<uint32_t> chains(bones.size(), 1);
+	maxChain = 0;
+	for (size_t bone = 0; bone < bones.size(); bone++) {
+		if (parent[bone] != Bone::root)
+			chains[bone] = chains[parent[bone]] + 1;
+		maxChain = std::max(maxChain, chains[bone]);
+	}
+
+	/* end of every subtree: pre-order => children extend the range of their parent */
+	std::vector<uint32_t> subtreeEnds(bones.size());
+	for (size_t bone = bones.size(); bone-- > 0;) {
+		subtreeEnds[bone] = std::max(subtreeEnds[bone], static_cast<uint32_t>(bone + 1));
+		if (parent[bone] != Bone::root)
+			subtreeEnds[parent[bone]] = std::max(subtreeEnds[parent[bone]], subtreeEnds[bone]);
+	}
+
+	/* large subtrees => spine | small ones are merged into runs of adjacent subtrees */
+	spine.clear();
+	subtrees.clear();
+	for (uint32_t bone = 0; bone < bones.size();) {
+		const uint32_t count = subtreeEnds[bone] - bone;
+		if (count > subtreeGrain) {
+			spine.push_back(bone++);
+			continue;
+		}
+
+		if (!subtrees.empty() && subtrees.back().first + subtrees.back().count == bone && subtrees.back().count + count <= subtreeGrain)
+			subtrees.back().count += count;
+		else
+			subtrees.push_back(ElementRange{ bone, count });
+		bone = subtreeEnds[bone];
+	}
+}
+
+size_t pje::engine::types::BoneRestFrames::size() const {
+	return axisX.size();
+}
 
 /* ################################################################################### */
 
-pje::engine::types::LSysObject::LSysObject() : m_matrices() {}
+pje::engine::types::PrimitiveRegistry::PrimitiveRegistry() : m_primitives() {}
+
+pje::engine::types::PrimitiveRegistry::PrimitiveRegistry(const std::vector<Primitive>& primitives) : m_primitives() {
+	for (size_t kind = 0; kind < kindCount; kind++) {
+		const std::string name = nameOf(static_cast<PrimitiveKind>(kind));
+		for (const auto& primitive : primitives) {
+			if (primitive.m_identifier.find(name) != std::string::npos) {
+				m_primitives[kind] = &primitive;
+				break;
+			}
+		}
+	}
+}
+
+pje::engine::types::PrimitiveRegistry::~PrimitiveRegistry() {}
+
+const pje::engine::types::Primitive& pje::engine::types::PrimitiveRegistry::at(PrimitiveKind kind) const {
+	const Primitive* primitive = m_primitives[static_cast<size_t>(kind)];
+	if (primitive == nullptr)
+		throw std::runtime_error(std::string("PrimitiveRegistry is missing primitive: ") + nameOf(kind));
+
+	return *primitive;
+}
+
+const char* pje::engine::types::PrimitiveRegistry::nameOf(PrimitiveKind kind) {
+	switch (kind) {
+	case PrimitiveKind::Ground:	return "ground";
+	case PrimitiveKind::Stem:	return "stem";
+	case PrimitiveKind::Leaf:	return "leaf";
+	default:					return "flower";
+	}
+}
+
+/* ################################################################################### */
+
+pje::engine::types::LSysObject::LSysObject() : m_matrices(), m_bounds(0.0f), m_windStrength(0.0f), m_boneFormat(BoneFormat::Matrix) {}
 
 pje::engine::types::LSysObject::~LSysObject() {}
 
+bool pje::engine::types::LSysObject::isInstanced() const {
+	return !m_instances.empty();
+}
+
+bool pje::engine::types::LSysObject::isCompact() const {
+	return !m_compactVertices.empty();
+}
+
+void pje::engine::types::LSysObject::compactVertices() {
+	m_compactVertices.resize(m_vertices.size());
+
+	/* AABB and lowest boneRef of every LSysPrimitive => its VertexDecode */
+	for (auto& primitive : m_objectPrimitives) {
+		glm::vec3	minPos(0.0f);
+		glm::vec3	maxPos(0.0f);
+		uint32_t	minBoneRef = 0;
+		uint32_t	maxBoneRef = 0;
+
+		if (primitive.vertexCount > 0) {
+			const Vertex& first = m_vertices[primitive.firstVertex];
+			minPos = maxPos	= first.m_pos;
+			minBoneRef		= first.m_boneAttrib.x;
+			maxBoneRef		= first.m_boneAttrib.x + first.m_boneAttrib.y;
+		}
+		for (uint32_t v = primitive.firstVertex; v < primitive.firstVertex + primitive.vertexCount; v++) {
+			minPos		= glm::min(minPos, m_vertices[v].m_pos);
+			maxPos		= glm::max(maxPos, m_vertices[v].m_pos);
+			minBoneRef	= std::min(minBoneRef, m_vertices[v].m_boneAttrib.x);
+			maxBoneRef	= std::max(maxBoneRef, m_vertices[v].m_boneAttrib.x + m_vertices[v].m_boneAttrib.y);
+		}
+
+		if (maxBoneRef - minBoneRef > std::numeric_limits<uint16_t>::max())
+			throw std::runtime_error("BoneRefs of a LSysPrimitive exceed the 16 bit of CompactVertex.");
+
+		primitive.decode = VertexDecode{ minPos, minBoneRef, maxPos - minPos, 1 };
+	}
+
+	/* quantization of all vertices */
+	std::for_each(
+		std::execution::par,
+		m_objectPrimitives.begin(),
+		m_objectPrimitives.end(),
+		[this](const LSysPrimitive& primitive) {
+			std::transform(
+				m_vertices.begin() + primitive.firstVertex,
+				m_vertices.begin() + primitive.firstVertex + primitive.vertexCount,
+				m_compactVertices.begin() + primitive.firstVertex,
+				[&primitive](const Vertex& vertex) { return CompactVertex(vertex, primitive.decode); }
+			);
+		}
+	);
+
+	/* primitives of every LSysLod are an ordered subset of m_objectPrimitives */
+	for (auto& lod : m_lods) {
+		size_t source = 0;
+		for (auto& primitive : lod.primitives) {
+			while (m_objectPrimitives[source].firstVertex != primitive.firstVertex)
+				source++;
+			primitive.decode = m_objectPrimitives[source].decode;
+		}
+	}
+
+	std::cout << 
+		"[PJE] \tCompact vertices: " << m_vertices.size() << " * " << sizeof(CompactVertex) << " Bytes instead of " << sizeof(Vertex) << " Bytes => " << 
+		(m_compactVertices.size() * sizeof(CompactVertex)) / 1024 << " KiB instead of " << (m_vertices.size() * sizeof(Vertex)) / 1024 << " KiB" << 
+	std::endl;
+}
+
+std::vector<pje::engine::types::LodRun> pje::engine::types::LSysObject::selectLods(uint32_t objectCount) const {
+	std::vector<LodRun> runs;
+	if (m_lods.empty()) {
+		runs.push_back(LodRun{ 0, 0, objectCount });
+		return runs;
+	}
+
+	for (uint32_t object = 0; object < objectCount; object++) {
+		/* finest LOD that is still large enough */
+		const float size = getProjectedSize(object);
+		uint32_t lod = 0;
+		while (lod + 1 < m_lods.size() && size < m_lods[lod].minScreenSize)
+			lod++;
+
+		/* neighbouring objects with the same LOD share their draw calls */
+		if (!runs.empty() && runs.back().lod == lod)
+			runs.back().objectCount++;
+		else
+			runs.push_back(LodRun{ lod, object, 1 });
+	}
+
+	return runs;
+}
+
+float pje::engine::types::LSysObject::getProjectedSize(uint32_t object) const {
+	glm::vec4 center = m_matrices.modelMatrix * glm::vec4(glm::vec3(m_bounds), 1.0f);
+	center.z += object * objectSpacing;
+
+	/* largest scale of modelMatrix => radius in world space */
+	const float scale = std::max(
+		glm::length(glm::vec3(m_matrices.modelMatrix[0])), 
+		std::max(glm::length(glm::vec3(m_matrices.modelMatrix[1])), glm::length(glm::vec3(m_matrices.modelMatrix[2])))
+	);
+	const float radius		= m_bounds.w * scale;
+	const float distance	= -(m_matrices.viewMatrix * center).z;
+
+	/* camera inside of the bounding sphere */
+	if (distance <= radius)
+		return std::numeric_limits<float>::max();
+
+	/* |projectionMatrix[1][1]| := cot(fovY / 2) => Vulkan flips its sign */
+	return radius * std::abs(m_matrices.projectionMatrix[1][1]) / distance;
+}
+
+pje::engine::types::CullStats pje::engine::types::LSysObject::cullPrimitives(const LodRun& run, std::vector<LSysPrimitive>& visible) const {
+	if (isInstanced())
+		throw std::runtime_error("LSysObject::cullPrimitives() requires placed copies => cullInstances().");
+
+	const bool		lodChain	= !m_lods.empty();
+	const uint32_t	maxDepth	= lodChain ? m_lods[run.lod].maxDepth : std::numeric_limits<uint32_t>::max();
+
+	/* deployed primitives of run (per object) */
+	const uint32_t total = static_cast<uint32_t>(lodChain ? m_lods[run.lod].primitives.size() : m_objectPrimitives.size());
+
+	visible.clear();
+	if (m_branchNodes.empty()) {
+		visible = lodChain ? m_lods[run.lod].primitives : m_objectPrimitives;
+		return CullStats{ total * run.objectCount, 0 };
+	}
+
+	std::array<glm::vec4, 6>	planes;
+	glm::mat4					modelMatrix;
+	float						runLength;
+	getCullFrustum(run, planes, modelMatrix, runLength);
+
+	cullBranch(0, planes, modelMatrix, runLength, maxDepth, false, visible);
+
+	const uint32_t drawn = static_cast<uint32_t>(visible.size());
+	return CullStats{ drawn * run.objectCount, (total - drawn) * run.objectCount };
+}
+
+pje::engine::types::CullStats pje::engine::types::LSysObject::cullInstances(const LodRun& run, std::vector<uint32_t>& visibleInstances, std::vector<InstanceRange>& visibleRanges) const {
+	const auto& ranges = m_lods.empty() ? m_instanceRanges : m_lods[run.lod].instanceRanges;
+
+	/* instances of run (per object) | LSysLod := prefix of every range */
+	uint32_t total = 0;
+	for (const auto& range : ranges)
+		total += range.count;
+
+	/* -1 => whole object outside | 0 => every instance is tested | 1 => whole object inside */
+	int side = 1;
+	std::array<glm::vec4, 6>	planes;
+	glm::mat4					modelMatrix;
+	float						runLength = 0.0f;
+	if (!m_branchNodes.empty() && m_instanceBounds.size() == m_instances.size()) {
+		getCullFrustum(run, planes, modelMatrix, runLength);
+		side = classifyBranch(m_branchNodes[0], planes, modelMatrix, runLength);
+	}
+
+	/* surviving instances of each source primitive are compacted => 1 range per source */
+	uint32_t drawn = 0;
+	for (const auto& range : ranges) {
+		const uint32_t first = static_cast<uint32_t>(visibleInstances.size());
+		if (side > 0) {
+			for (uint32_t instance = range.first; instance < range.first + range.count; instance++)
+				visibleInstances.push_back(instance);
+		}
+		else if (side == 0) {
+			for (uint32_t instance = range.first; instance < range.first + range.count; instance++) {
+				const InstanceBounds& bounds = m_instanceBounds[instance];
+				if (classifyBounds(bounds.min, bounds.max, bounds.windLever, bounds.windChain, planes, modelMatrix, runLength) >= 0)
+					visibleInstances.push_back(instance);
+			}
+		}
+
+		const uint32_t count = static_cast<uint32_t>(visibleInstances.size()) - first;
+		visibleRanges.push_back(InstanceRange{ first, count });
+		drawn += count;
+	}
+
+	return CullStats{ drawn * run.objectCount, (total - drawn) * run.objectCount };
+}
+
+void pje::engine::types::LSysObject::cullBranch(
+	uint32_t node, 
+	const std::array<glm::vec4, 6>& planes, 
+	const glm::mat4& modelMatrix, 
+	float runLength, 
+	uint32_t maxDepth, 
+	bool inside, 
+	std::vector<LSysPrimitive>& visible
+) const {
+	const LSysBranchNode& branch = m_branchNodes[node];
+	if (branch.depth > maxDepth)
+		return;
+
+	if (!inside) {
+		const int side = classifyBranch(branch, planes, modelMatrix, runLength);
+		if (side < 0)
+			return;
+		inside = side > 0;
+	}
+
+	const uint32_t end = branch.firstDeployed + branch.deployedCount;
+
+	/* whole branch is visible and not pruned => 1 copy of its range */
+	if (inside && branch.maxDepth <= maxDepth) {
+		visible.insert(visible.end(), m_objectPrimitives.begin() + branch.firstDeployed, m_objectPrimitives.begin() + end);
+		return;
+	}
+
+	/* primitives of this branch lie between its sub-branches */
+	uint32_t deployed = branch.firstDeployed;
+	for (uint32_t child = node + 1; child < branch.skip; child = m_branchNodes[child].skip) {
+		const LSysBranchNode& subBranch = m_branchNodes[child];
+		visible.insert(visible.end(), m_objectPrimitives.begin() + deployed, m_objectPrimitives.begin() + subBranch.firstDeployed);
+		cullBranch(child, planes, modelMatrix, runLength, maxDepth, inside, visible);
+		deployed = subBranch.firstDeployed + subBranch.deployedCount;
+	}
+	visible.insert(visible.end(), m_objectPrimitives.begin() + deployed, m_objectPrimitives.begin() + end);
+}
+
+void pje::engine::types::LSysObject::getCullFrustum(const LodRun& run, std::array<glm::vec4, 6>& planes, glm::mat4& modelMatrix, float& runLength) const {
+	/* planes of the view frustum in world space (Gribb/Hartmann) := (normal, distance) | GL near plane is kept for Vulkan => conservative */
+	const glm::mat4 viewProjection = glm::transpose(m_matrices.projectionMatrix * m_matrices.viewMatrix);
+	planes = {
+		viewProjection[3] + viewProjection[0], viewProjection[3] - viewProjection[0],
+		viewProjection[3] + viewProjection[1], viewProjection[3] - viewProjection[1],
+		viewProjection[3] + viewProjection[2], viewProjection[3] - viewProjection[2]
+	};
+
+	/* objects of run are shifted along z (world space) => AABBs are stretched over all of them */
+	modelMatrix = m_matrices.modelMatrix;
+	modelMatrix[3].z += run.firstObject * objectSpacing;
+	runLength = (run.objectCount - 1) * objectSpacing;
+}
+
+int pje::engine::types::LSysObject::classifyBranch(const LSysBranchNode& node, const std::array<glm::vec4, 6>& planes, const glm::mat4& modelMatrix, float runLength) const {
+	return classifyBounds(node.min, node.max, node.windLever, node.windChain, planes, modelMatrix, runLength);
+}
+
+int pje::engine::types::LSysObject::classifyBounds(
+	const glm::vec3& min, 
+	const glm::vec3& max, 
+	float windLever, 
+	uint32_t windChain, 
+	const std::array<glm::vec4, 6>& planes, 
+	const glm::mat4& modelMatrix, 
+	float runLength
+) const {
+	if (min.x > max.x)
+		return -1;
+
+	/* k-th bone of a chain turns everything below it by up to k * m_windStrength radians => chord of the whole chain along windLever */
+	const float padding = windLever * 2.0f * std::sin(0.5f * std::min(windChain * m_windStrength, 3.1415927f));
+
+	/* AABB in object space => AABB in world space | center and extent */
+	const glm::vec3 objectCenter	= 0.5f * (min + max);
+	const glm::vec3 objectExtent	= 0.5f * (max - min) + glm::vec3(padding);
+	const glm::mat3 linear			= glm::mat3(modelMatrix);
+
+	glm::vec3 center	= glm::vec3(modelMatrix * glm::vec4(objectCenter, 1.0f));
+	glm::vec3 extent	= glm::vec3(0.0f);
+	for (int column = 0; column < 3; column++)
+		extent += glm::abs(linear[column]) * objectExtent[column];
+	center.z += 0.5f * runLength;
+	extent.z += 0.5f * runLength;
+
+	int side = 1;
+	for (const auto& plane : planes) {
+		const glm::vec3	normal		= glm::vec3(plane);
+		const float		distance	= glm::dot(normal, center) + plane.w;
+		const float		radius		= glm::dot(glm::abs(normal), extent);
+
+		if (distance + radius < 0.0f)
+			return -1;
+		if (distance - radius < 0.0f)
+			side = 0;
+	}
+	return side;
+}
+
 void pje::engine::types::LSysObject::placeObjectInWorld(const glm::vec3 translation, const float rotationDegreesY, const glm::vec3 scale) {
 	const static glm::mat4 identityMat = glm::mat4(1.0f);
 
@@ -96,28 +569,139 @@ void pje::engine::types::LSysObject::updateMVP() {
 }
 
 void pje::engine::types::LSysObject::animWindBlow(const float deltaChange, const float blowStrength) {
-	/* Updates m_bones to simulate an even changing wind power affecting the bones */
+	/* Updates m_bonePalette to simulate an even changing wind power affecting the bones */
 
 	constexpr float PI						= 3.1415927f;
-	const static glm::mat4 identityMat		= glm::mat4(1.0f);
 	const static float tiltUnitInRadians	= 20.0f * (PI / 180.0f);
 
-	glm::mat4 tiltMat = glm::rotate(
-		identityMat, std::sinf(tiltUnitInRadians * deltaChange) * blowStrength, glm::vec3(0.0f, 0.0f, 1.0f)
+	/* tilts add up along a chain of bones => blowStrength is shared by the bones of the longest chain */
+	const float localStrength = blowStrength / std::max(m_boneRestFrames.maxChain, 1u);
+
+	/* local tilt of every bone around its restpose => parents before children: tilt of a branch adds to the one of its parent */
+	pje::engine::BoneKernel::windPalette(
+		m_boneRestFrames, m_bonePalette.data(), std::sinf(tiltUnitInRadians * deltaChange) * localStrength
 	);
+	pje::engine::BoneKernel::cascadePalette(m_boneRestFrames, m_bonePalette.data());
+	packBones(0, m_bonePalette.size());
+	markAllBonesDirty();
+
+	/* local tilt of every bone stays <= |localStrength| radians => tips of the longest chain <= |blowStrength| */
+	m_windStrength = std::abs(localStrength);
+}
+
+void pje::engine::types::LSysObject::setAnimationpose(uint32_t bone, const glm::mat4& animationpose) {
+	m_bones[bone].animationpose		= animationpose;
+	m_bonePalette[bone].matrix		= animationpose * m_bones[bone].restpose.inverse().toMat4();
+	m_dirtyBones[bone / 64]			|= uint64_t(1) << (bone % 64);
+	packBones(bone, 1);
+}
 
-	// TODO(scene graph animation => child-parent-relation required)
-	for (auto& bone : m_bones) {
-		bone.animationpose = bone.restpose * tiltMat;
+void pje::engine::types::LSysObject::resetBonePalette() {
+	m_bonePalette.resize(m_bones.size());
+	for (size_t bone = 0; bone < m_bones.size(); bone++) {
+		m_bonePalette[bone].matrix = m_bones[bone].animationpose * m_bones[bone].restpose.inverse().toMat4();
 	}
+	m_boneRestFrames.assign(m_bones);
+
+	/* packed copy of the current format => all entries dirty */
+	setBoneFormat(m_boneFormat);
 }
 
-std::vector<glm::mat4> pje::engine::types::LSysObject::getBoneMatrices() const {
-	std::vector<glm::mat4> res;
+void pje::engine::types::LSysObject::setBoneFormat(BoneFormat format) {
+	m_boneFormat = format;
+
+	/* only the packed copy of format is kept */
+	m_boneAffines.resize(format == BoneFormat::Affine ? m_bonePalette.size() : 0);
+	m_boneDualQuats.resize(format == BoneFormat::DualQuaternion ? m_bonePalette.size() : 0);
+	m_boneAffines.shrink_to_fit();
+	m_boneDualQuats.shrink_to_fit();
+
+	packBones(0, m_bonePalette.size());
+	markAllBonesDirty();
+}
 
-	for (const auto& bone : m_bones) {
-		res.push_back(bone.animationpose * bone.restposeInv);
+pje::engine::types::LSysObject::BoneFormat pje::engine::types::LSysObject::getBoneFormat() const {
+	return m_boneFormat;
+}
+
+size_t pje::engine::types::LSysObject::getBoneStride() const {
+	switch (m_boneFormat) {
+	case BoneFormat::Affine:			return sizeof(BoneAffine);
+	case BoneFormat::DualQuaternion:	return sizeof(BoneDualQuat);
+	default:							return sizeof(BoneMatrix);
+	}
+}
+
+const void* pje::engine::types::LSysObject::getBoneData() const {
+	switch (m_boneFormat) {
+	case BoneFormat::Affine:			return m_boneAffines.data();
+	case BoneFormat::DualQuaternion:	return m_boneDualQuats.data();
+	default:							return m_bonePalette.data();
 	}
+}
+
+void pje::engine::types::LSysObject::getDirtyBoneRanges(std::vector<ElementRange>& ranges) const {
+	ranges.clear();
+
+	for (uint32_t word = 0; word < m_dirtyBones.size(); word++) {
+		uint64_t bits = m_dirtyBones[word];
+
+		/* clean words are skipped as a whole */
+		for (uint32_t bit = 0; bits != 0; bit++, bits >>= 1) {
+			if ((bits & 1) == 0)
+				continue;
+
+			const uint32_t bone = word * 64 + bit;
+			if (!ranges.empty() && ranges.back().first + ranges.back().count == bone)
+				ranges.back().count++;
+			else
+				ranges.push_back(ElementRange{ bone, 1 });
+		}
+	}
+}
+
+void pje::engine::types::LSysObject::clearDirtyBones() {
+	std::fill(m_dirtyBones.begin(), m_dirtyBones.end(), uint64_t(0));
+}
+
+void pje::engine::types::LSysObject::packBones(size_t first, size_t count) {
+	/* whole palettes of large skeletons => std::execution::par */
+	auto pack = [&](auto* packed, auto convert) {
+		if (count < pje::engine::BoneKernel::parallelThreshold)
+			std::transform(m_bonePalette.begin() + first, m_bonePalette.begin() + first + count, packed + first, convert);
+		else
+			std::transform(std::execution::par, m_bonePalette.begin() + first, m_bonePalette.begin() + first + count, packed + first, convert);
+	};
+
+	switch (m_boneFormat) {
+	case BoneFormat::Affine:
+		pack(m_boneAffines.data(), [](const BoneMatrix& bone) {
+			/* row r := (column 0..3)[r] */
+			BoneAffine affine;
+			for (int row = 0; row < 3; row++)
+				affine.rows[row] = glm::vec4(bone.matrix[0][row], bone.matrix[1][row], bone.matrix[2][row], bone.matrix[3][row]);
+			return affine;
+		});
+		break;
+	case BoneFormat::DualQuaternion:
+		pack(m_boneDualQuats.data(), [](const BoneMatrix& bone) {
+			/* dual := 0.5 * (translation, 0) * real => (0.5 * (w * t + t x r), -0.5 * dot(r, t)) | t x r (not r x t) matches the translation of both vertex shaders */
+			const glm::quat	rotation	= glm::quat_cast(glm::mat3(bone.matrix));
+			const glm::vec3	r			= glm::vec3(rotation.x, rotation.y, rotation.z);
+			const glm::vec3	t			= glm::vec3(bone.matrix[3]);
+			return BoneDualQuat{
+				glm::vec4(r, rotation.w),
+				glm::vec4(0.5f * (rotation.w * t + glm::cross(t, r)), -0.5f * glm::dot(r, t))
+			};
+		});
+		break;
+	default:
+		break;
+	}
+}
 
-	return res;
+void pje::engine::types::LSysObject::markAllBonesDirty() {
+	m_dirtyBones.assign((m_bones.size() + 63) / 64, ~uint64_t(0));
+	if (m_bones.size() % 64 != 0)
+		m_dirtyBones.back() = (uint64_t(1) << (m_bones.size() % 64)) - 1;
 }
\ No newline at end of file
@@ -9,10 +9,18 @@
 	#include <memory>							// std::<smartPointer>
 	#include <chrono>							// (animation) time measurement
 	#include <cmath>							// (animation) math functions
+	#include <stdexcept>						// std::runtime_error
+	#include <limits>							// std::numeric_limits
+	#include <algorithm>						// std::max
+	#include <execution>						// parallel algorithms
+	#include <iostream>							// i/o stream
 
 	#include <vulkan/vulkan.h>					// Vulkan
 	#include <glm/glm.hpp>						// glm types
 	#include <glm/gtc/matrix_transform.hpp>		// glm matrix operations
+	#include <glm/gtc/quaternion.hpp>			// glm quaternions
+	#include <glm/gtc/type_precision.hpp>		// glm 16 bit vectors
+	#include <glm/gtc/packing.hpp>				// glm half floats
 	#include <stb_image.h>						// stb
 
 /* PJE Types - holding data for both Vulkan and OpenGL */
@@ -26,7 +34,7 @@ namespace pje::engine::types {
 		glm::vec2	m_uv;
 		glm::uvec2	m_boneAttrib;
 
-		Vertex() = delete;
+		Vertex() = default;		// uninitialized slot of LSysObject::m_vertices => written by TurtleInterpreter
 		Vertex(glm::vec3 pos, glm::vec3 normal, glm::vec2 uv, glm::uvec2 boneAttrib = glm::uvec2(0, 0));
 		~Vertex();
 
@@ -35,6 +43,36 @@ namespace pje::engine::types {
 		static VkVertexInputBindingDescription getVulkanBindingDesc();
 	};
 
+	/* VertexDecode - CompactVertex => object space | set per draw call (push constant | uniform) | compact == 0 => Vertex is drawn unchanged */
+	struct VertexDecode {
+		glm::vec3	positionMin;		// AABB of the LSysPrimitive
+		uint32_t	boneRefBase;		// added to CompactVertex::m_boneAttrib[0]
+		glm::vec3	positionExtent;
+		uint32_t	compact;
+	};
+
+	/* CompactVertex - quantized Vertex (20 instead of 40 bytes) => LSysObject::compactVertices()
+	*	>> [INFO]	m_pos := unorm16 inside of the AABB of its LSysPrimitive | m_normal := octahedral snorm16 | m_uv := half float
+	*	>> [INFO]	decoded by the vertex shaders via VertexDecode of each LSysPrimitive
+	*/
+	class CompactVertex {
+	public:
+		glm::u16vec4	m_pos;			// w := 0 => 4 byte aligned and supported by every Vulkan device
+		glm::i16vec2	m_normal;
+		glm::u16vec2	m_uv;
+		glm::u16vec2	m_boneAttrib;	// u16vec2(<first relevant boneRef> - VertexDecode::boneRefBase, <boneRefsCount for this vertex>)
+
+		CompactVertex() = default;
+		CompactVertex(const Vertex& vertex, const VertexDecode& decode);
+
+		/* same decode as the vertex shaders */
+		Vertex decode(const VertexDecode& decode) const;
+
+		/* Vulkan-specific */
+		static std::array<VkVertexInputAttributeDescription, 4> getVulkanAttribDesc();
+		static VkVertexInputBindingDescription getVulkanBindingDesc();
+	};
+
 	/* Texture - 1 Primitive <-> 1 Texture | uncompressedTexture := ABGR8888 */
 	struct Texture {
 		std::string					name;
@@ -62,16 +100,123 @@ namespace pje::engine::types {
 		float		weight;
 	};
 
+	/* RigidTransform - rotation and translation without scale := T * R (28 bytes instead of 64 bytes of a glm::mat4)
+	*	>> [INFO]	inverse is closed-form => R^-1 * T^-1 without a general 4x4 inverse
+	*	>> [INFO]	converted to glm::mat4 only when matrices are emitted
+	*/
+	struct RigidTransform {
+		glm::quat rotation		= glm::quat(1.0f, 0.0f, 0.0f, 0.0f);	// unit quaternion
+		glm::vec3 translation	= glm::vec3(0.0f);
+
+		/* this * local */
+		RigidTransform operator*(const RigidTransform& local) const;
+		/* this * T(localTranslation) */
+		RigidTransform translated(const glm::vec3& localTranslation) const;
+		/* this * R(localRotation) | rotation is renormalized against drift */
+		RigidTransform rotated(const glm::quat& localRotation) const;
+		RigidTransform inverse() const;
+		glm::mat4 toMat4() const;
+	};
+
 	/* Bone - shared data container for multiple Primitive(s) */
 	struct Bone {
 		/* BoneMatrix (for shaders) := animationpose * restposeInv | [ O'_i * O_i^-1 ]
-		*	- transformation matrix	(1)				(m_restpose)		: local/primitive/bone space -> object space
-		*	- "local view transformation" matrix	(m_restposeInv)		: object space -> local/primitive/bone space
-		*	- transformation matrix (2)				(m_animationpose)	: bone space -> object space
+		*	- rigid transformation	(1)				(restpose)			: local/primitive/bone space -> object space
+		*	- "local view transformation" matrix	(restpose.inverse()): object space -> local/primitive/bone space
+		*	- transformation matrix (2)				(animationpose)		: bone space -> object space
 		*/
-		glm::mat4 restpose;			// O_i		= O_(i-1)  * T_y_i    * R_i
-		glm::mat4 restposeInv;		// O_i^-1	= R_i^-1   * T_y_i^-1 * O_(i-1)^-1
-		glm::mat4 animationpose;	// O'_i		= O_i      * <transformation matrix>
+		RigidTransform	restpose;		// O_i		= O_(i-1)  * T_y_i    * R_i
+		glm::mat4		animationpose;	// O'_i		= O_i      * <transformation matrix>
+		uint32_t		parent = root;	// bone of the enclosing branch => always created before this bone
+
+		static constexpr uint32_t root = std::numeric_limits<uint32_t>::max();	// parent of the first bone
+	};
+
+	/* BoneMatrix - 1 entry of LSysObject::m_bonePalette := animationpose * restposeInv
+	*	>> [INFO]	aligned to 1 cache line => same layout as mat4[] of the shaders (std430 and std140)
+	*/
+	struct alignas(64) BoneMatrix {
+		glm::mat4	matrix;
+	};
+	static_assert(sizeof(BoneMatrix) == sizeof(glm::mat4), "BoneMatrix must match mat4[] of the shaders.");
+
+	/* BoneAffine - BoneMatrix without its last row (0, 0, 0, 1) := rows of the upper 3x4 => vec4[3] of the shaders (48 instead of 64 bytes) */
+	struct BoneAffine {
+		glm::vec4	rows[3];
+	};
+
+	/* BoneDualQuat - rigid BoneMatrix as unit dual quaternion => vec4[2] of the shaders (32 instead of 64 bytes)
+	*	>> [INFO]	real := rotation (x, y, z, w) | dual := 0.5 * (translation, 0) * real
+	*	>> [INFO]	normals are rotated by real => no transpose(inverse()) per vertex
+	*/
+	struct BoneDualQuat {
+		glm::vec4	real;
+		glm::vec4	dual;
+	};
+
+	/* ElementRange - elements [first, first + count) of 1 container of LSysObject (dirty entries of m_bonePalette, a run of subtrees or a patched range) */
+	struct ElementRange {
+		uint32_t	first;
+		uint32_t	count;
+	};
+
+	/* BoneRestFrames - restposes of LSysObject::m_bones as SoA (28 bytes per bone) => BoneKernel
+	*	>> [INFO]	axis := restpose.rotation * (0, 0, 1) | origin := restpose.translation
+	*	>> [INFO]	restpose * R_z(angle) * restposeInv == rotation by angle around axis through origin
+	*	>> [INFO]	bones are in pre-order (parents before children) => every subtree is a contiguous range of bones
+	*/
+	struct BoneRestFrames {
+		std::vector<float>			axisX;
+		std::vector<float>			axisY;
+		std::vector<float>			axisZ;
+		std::vector<float>			originX;
+		std::vector<float>			originY;
+		std::vector<float>			originZ;
+		std::vector<uint32_t>		parent;		// Bone::parent
+		std::vector<uint32_t>		spine;		// bones whose subtree exceeds subtreeGrain (ascending) => cascaded first
+		std::vector<ElementRange>	subtrees;	// all other bones as runs of whole subtrees <= subtreeGrain => cascaded concurrently
+		uint32_t					maxChain = 0;	// most bones on 1 chain root bone -> bone => their tilts add up
+
+		static constexpr uint32_t subtreeGrain = 4096;
+
+		void assign(const std::vector<Bone>& bones);
+		size_t size() const;
+	};
+
+	/* PrimitiveInstance - instanced LSysObject: 1 deployed primitive <-> 1 PrimitiveInstance (std430 layout) */
+	struct PrimitiveInstance {
+		glm::mat4	transform;		// primitive space -> object space := turtle position * scale
+		uint32_t	primitiveId;	// index into LSysObject::m_objectPrimitives
+		uint32_t	boneRefId;		// first BoneRef of this instance
+		uint32_t	boneRefCount;	// 0 => restpose only
+		uint32_t	depth;			// nesting depth of its branch => LSysLod
+	};
+
+	/* InstanceRange - LSysObject::m_instances[first, first + count) share the same source primitive | cullInstances(): part of its visible instances */
+	struct InstanceRange {
+		uint32_t	first;
+		uint32_t	count;
+	};
+
+	/* InstanceBounds - AABB of 1 PrimitiveInstance in object space (restpose) => padded like an LSysBranchNode */
+	struct InstanceBounds {
+		glm::vec3	min;			// min > max => source primitive has no vertices
+		float		windLever;		// longest path of its corners along their bone chain
+		glm::vec3	max;
+		uint32_t	windChain;		// most bones on the chain of its corners
+	};
+
+	/* LSysObjectPatch - elements of LSysObject rewritten by PlantTurtle::rebuildLSysObject() => GPU buffers are patched via updateRenderable() of both renderers
+	*	>> [INFO]	ranges are elements [first, first + count) of m_vertices, m_indices, m_bones, m_boneRefs and m_instances
+	*	>> [INFO]	elements before first are untouched | every container ends at first + count (it may have shrunk)
+	*/
+	struct LSysObjectPatch {
+		ElementRange	vertices;
+		ElementRange	indices;
+		ElementRange	bones;
+		ElementRange	boneRefs;
+		ElementRange	instances;
+		bool			complete;		// true => full build, every range starts at 0
 	};
 
 	/* Mesh - 1 Primitive <-> n Mesh(es) */
@@ -98,39 +243,196 @@ namespace pje::engine::types {
 		virtual ~Primitive();
 	};
 
-	/* LSysPrimitive - modified Primitives | logical component of LSysObject */
-	class LSysPrimitive final : public Primitive {
+	/* PrimitiveKind - primitives known by PlantTurtle | index into PrimitiveRegistry */
+	enum class PrimitiveKind : uint8_t { Ground, Stem, Leaf, Flower };
+
+	/* PrimitiveRegistry - references the Primitive of each PrimitiveKind => resolved once, primitives are never copied
+	*	>> [INFO]	Primitive of a kind := first primitive whose identifier contains nameOf(kind)
+	*	>> [INFO]	referenced vector of Primitives must outlive this registry and must not be resized
+	*/
+	class PrimitiveRegistry {
 	public:
-		uint32_t						m_offsetPriorPrimitivesVertices	= 0;	// helper: address this primitive's vertices count
-		uint32_t						m_offsetPriorPrimitivesIndices	= 0;	// helper: address this primitive's indices count
+		static constexpr size_t kindCount = 4;
+
+		PrimitiveRegistry();
+		explicit PrimitiveRegistry(const std::vector<Primitive>& primitives);
+		~PrimitiveRegistry();
+
+		/* throws if primitives had no Primitive of kind */
+		const Primitive& at(PrimitiveKind kind) const;
+		static const char* nameOf(PrimitiveKind kind);
+
+	private:
+		std::array<const Primitive*, kindCount> m_primitives;
+	};
+
+	/* LSysPrimitive - view of 1 deployed Primitive inside of the arenas of LSysObject | 1 draw := (indexCount, firstIndex, firstVertex) */
+	struct LSysPrimitive {
+		uint32_t	firstVertex;	// LSysObject::m_vertices[firstVertex, firstVertex + vertexCount) | base vertex of its indices
+		uint32_t	vertexCount;
+		uint32_t	firstIndex;		// LSysObject::m_indices[firstIndex, firstIndex + indexCount)
+		uint32_t	indexCount;
+		uint32_t	depth;			// nesting depth of its branch => LSysLod
+		VertexDecode	decode;			// set via LSysObject::compactVertices() | 0 => Vertex
+	};
+
+	/* LSysLod - coarser LSysObject: branches nested deeper than maxDepth are pruned => shares vertices, indices, bones and boneRefs
+	*	>> [INFO]	copies: subset of LSysObject::m_objectPrimitives | instanced: prefix of every instance range (sorted by depth per source)
+	*/
+	struct LSysLod {
+		uint32_t					maxDepth;
+		float						minScreenSize;		// used while the projected object covers >= minScreenSize of the viewport height
+		uint64_t					triangles;			// per object
+		std::vector<LSysPrimitive>	primitives;			// copies only
+		std::vector<InstanceRange>	instanceRanges;		// instanced only | [primitiveId]
+	};
+
+	/* LodRun - objects [firstObject, firstObject + objectCount) are drawn with LSysObject::m_lods[lod] */
+	struct LodRun {
+		uint32_t	lod;
+		uint32_t	firstObject;
+		uint32_t	objectCount;
+	};
+
+	/* LSysBranchNode - node of the branch BVH of LSysObject := 1 node per '[' in pre-order (node 0 := whole LSysObject)
+	*	>> [INFO]	a branch deploys its primitives and those of its sub-branches in one piece => [firstDeployed, firstDeployed + deployedCount)
+	*	>> [INFO]	copies: index into LSysObject::m_objectPrimitives | instanced: PrimitiveInstance in deploy order
+	*/
+	struct LSysBranchNode {
+		glm::vec3	min;			// AABB in object space (restpose) of the branch and its sub-branches | min > max => nothing deployed
+		float		windLever;		// longest path of those vertices along their bone chain (root bone -> bone -> vertex) => padding for animWindBlow()
+		glm::vec3	max;
+		uint32_t	depth;			// nesting depth of the branch => LSysLod
+		uint32_t	firstDeployed;
+		uint32_t	deployedCount;
+		uint32_t	skip;			// next node that isn't a sub-branch of this node
+		uint32_t	maxDepth;		// deepest sub-branch
+		uint32_t	windChain;		// most bones on the chain of those vertices => their tilts add up
+	};
 
-		LSysPrimitive();
-		~LSysPrimitive();
+	/* CullStats - deployed primitives (instanced: PrimitiveInstances) of 1 frame inside and outside of the view frustum */
+	struct CullStats {
+		uint32_t	visible;
+		uint32_t	culled;
 	};
 
 	/* LSysObject - created by TurtleInterpreter | represents logical renderable */
 	class LSysObject {
 	public:
 		enum class API { Vulkan, OpenGL };				// Y Axis -> +infinite ==> Vulkan down & OpenGL up
+		enum class BoneFormat { Matrix, Affine, DualQuaternion };	// 1 bone of the uploaded palette := BoneMatrix | BoneAffine | BoneDualQuat
 
-		std::vector<LSysPrimitive>	m_objectPrimitives; // primitives placed in object space
+		std::vector<LSysPrimitive>	m_objectPrimitives; // primitives placed in object space | instanced: every source primitive once (primitive space)
+		std::vector<Vertex>			m_vertices;			// arena: vertices of all m_objectPrimitives => uploaded with 1 copy
+		std::vector<uint32_t>		m_indices;			// arena: indices of all m_objectPrimitives (relative to LSysPrimitive::firstVertex)
+		std::vector<PrimitiveInstance>	m_instances;	// instanced: grouped by primitiveId | empty => primitives are placed copies
+		std::vector<InstanceRange>		m_instanceRanges;	// instanced: [primitiveId] := instances of m_objectPrimitives[primitiveId]
+		std::vector<InstanceBounds>		m_instanceBounds;	// instanced: [instance] := AABB of m_instances[instance] | empty => nothing is culled
 		MVPMatrices					m_matrices;			// object space -> world/camera/screen space
 
 		Texture						m_choosenTexture;	// PROJECT LIMITATION: same texture map for all primitives
 		std::vector<Bone>			m_bones;			// PROJECT LIMITATION: 1 boneMatrix <-> 1+ LSysPrimitive   !!!
 		std::vector<BoneRef>		m_boneRefs;			// PROJECT LIMITATION: 1 boneRef	<-> 1  LSysPrimitive
+		std::vector<LSysLod>		m_lods;				// m_lods[0] := full object | empty => no LOD chain
+		glm::vec4					m_bounds;			// bounding sphere in object space := (center, radius)
+		std::vector<LSysBranchNode>	m_branchNodes;		// branch BVH in pre-order | empty => nothing is culled
+		float						m_windStrength;		// local tilt of every bone of the latest animWindBlow() => padding of m_branchNodes
+		std::vector<CompactVertex>	m_compactVertices;	// arena: quantized m_vertices | empty => m_vertices are uploaded
+		std::vector<BoneMatrix>		m_bonePalette;		// [boneId] := BoneMatrix of m_bones[boneId] => uploaded as is
+		std::vector<uint64_t>		m_dirtyBones;		// bitmap: 1 bit per entry of m_bonePalette changed since clearDirtyBones()
+		BoneRestFrames				m_boneRestFrames;	// SoA: restposes of m_bones => animWindBlow()
+		std::vector<BoneAffine>		m_boneAffines;		// BoneFormat::Affine: [boneId] := packed m_bonePalette[boneId] | empty otherwise
+		std::vector<BoneDualQuat>	m_boneDualQuats;	// BoneFormat::DualQuaternion: [boneId] := packed m_bonePalette[boneId] | empty otherwise
+
+		/* distance between the objects drawn per instance => matches posOut.z += <object> * 1.5f of every vertex shader */
+		static constexpr float		objectSpacing = 1.5f;
 
 		LSysObject();
 		~LSysObject();
 
+		/* true if m_objectPrimitives are drawn once per PrimitiveInstance */
+		bool isInstanced() const;
+		/* true if m_compactVertices are uploaded instead of m_vertices */
+		bool isCompact() const;
+		/* quantizes m_vertices into m_compactVertices and sets VertexDecode of all LSysPrimitives (LSysLods included)
+		*	>> [INFO]	throws if the BoneRefs of 1 LSysPrimitive exceed 16 bit
+		*/
+		void compactVertices();
+
+		/* LOD logic => m_lods of objectCount objects by their projected size | no LOD chain => 1 run of full objects */
+		std::vector<LodRun> selectLods(uint32_t objectCount) const;
+		/* fraction of viewport height covered by m_bounds of object */
+		float getProjectedSize(uint32_t object) const;
+		/* culling logic => m_branchNodes of all objects of run against the view frustum of m_matrices (padded by m_windStrength)
+		*	>> [INFO]	copies only: visible := LSysPrimitives of run to draw | throws if instanced => cullInstances()
+		*/
+		CullStats cullPrimitives(const LodRun& run, std::vector<LSysPrimitive>& visible) const;
+		/* culling logic => m_instanceBounds of the LSysLod of run against the view frustum of m_matrices (padded by m_windStrength)
+		*	>> [INFO]	instanced only: visibleInstances += indices into m_instances of the visible instances (compacted per source primitive)
+		*	>> [INFO]	visibleRanges += 1 InstanceRange per source primitive := its part of visibleInstances => 1 draw per range
+		*/
+		CullStats cullInstances(const LodRun& run, std::vector<uint32_t>& visibleInstances, std::vector<InstanceRange>& visibleRanges) const;
+
 		/* scene logic */
 		void placeObjectInWorld(const glm::vec3 translation, const float rotationDegreesY, const glm::vec3 scale);
 		void placeCamera(const glm::vec3 posInWorld, const glm::vec3 focusCenter, const glm::vec3 cameraUp);
 		void setPerspective(const float fovY, const float aspectRatio, const float nearPlane, const float farPlane, API api);
 		void updateMVP();
 
-		/* animation logic => m_bones manipulation */
+		/* animation logic => m_bonePalette is written in place
+		*	>> [INFO]	animWindBlow() fuses restpose * tilt * restposeInv of all bones via BoneKernel => m_bones stay untouched
+		*	>> [INFO]	animWindBlow() cascades the tilts along Bone::parent in 1 pre-order sweep => a branch follows the motion of its parent
+		*/
 		void animWindBlow(const float deltaChange, const float blowStrength = 1.0f);
-		std::vector<glm::mat4> getBoneMatrices() const;
+		/* m_bones[bone].animationpose := animationpose => its BoneMatrix is marked dirty */
+		void setAnimationpose(uint32_t bone, const glm::mat4& animationpose);
+
+		/* palette logic => m_bonePalette of all m_bones (all entries dirty) | called after every build of m_bones */
+		void resetBonePalette();
+		/* palette format logic => m_bonePalette is packed into the uploaded format once per change (all entries dirty)
+		*	>> [INFO]	BoneFormat::DualQuaternion expects rigid BoneMatrices (animWindBlow()) => scale or shear of setAnimationpose() is lost
+		*/
+		void setBoneFormat(BoneFormat format);
+		BoneFormat getBoneFormat() const;
+		/* bytes per bone of the uploaded palette */
+		size_t getBoneStride() const;
+		/* m_bonePalette in getBoneFormat() => uploaded as is | bone i starts at i * getBoneStride() */
+		const void* getBoneData() const;
+		/* copies: ranges := adjacent dirty entries of m_bonePalette (ascending) */
+		void getDirtyBoneRanges(std::vector<ElementRange>& ranges) const;
+		/* called by the owner of the GPU copy after the dirty ranges were uploaded */
+		void clearDirtyBones();
+
+	private:
+		BoneFormat m_boneFormat;
+
+		/* every entry of m_bonePalette => dirty | bits beyond m_bones stay 0 */
+		void markAllBonesDirty();
+		/* m_bonePalette [first, first + count) => m_boneAffines | m_boneDualQuats (BoneFormat::Matrix => nothing to pack) */
+		void packBones(size_t first, size_t count);
+
+		/* appends the visible LSysPrimitives of m_branchNodes[node] (inside => no plane tests) | sub-branches deeper than maxDepth are pruned */
+		void cullBranch(
+			uint32_t node, 
+			const std::array<glm::vec4, 6>& planes, 
+			const glm::mat4& modelMatrix, 
+			float runLength, 
+			uint32_t maxDepth, 
+			bool inside, 
+			std::vector<LSysPrimitive>& visible
+		) const;
+		/* planes of the view frustum in world space | modelMatrix of the first object of run | runLength := distance to its last object */
+		void getCullFrustum(const LodRun& run, std::array<glm::vec4, 6>& planes, glm::mat4& modelMatrix, float& runLength) const;
+		/* -1 => outside | 0 => intersecting | 1 => inside of planes */
+		int classifyBranch(const LSysBranchNode& node, const std::array<glm::vec4, 6>& planes, const glm::mat4& modelMatrix, float runLength) const;
+		int classifyBounds(
+			const glm::vec3& min, 
+			const glm::vec3& max, 
+			float windLever, 
+			uint32_t windChain, 
+			const std::array<glm::vec4, 6>& planes, 
+			const glm::mat4& modelMatrix, 
+			float runLength
+		) const;
 	};
 }
\ No newline at end of file
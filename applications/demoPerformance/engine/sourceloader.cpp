@@ -6,6 +6,7 @@
 pje::engine::Sourceloader::Sourceloader() : m_primitives(), 
 											m_primitivePaths(), 
 											m_activePrimitivesCount(0),  
+											m_registry(), 
 											m_centerPrimitive(false), 
 											m_sourceFolder("assets/primitives") {
 	/* looking for .fbx elements in m_sourceFolder to load data from those filepaths */
@@ -18,6 +19,8 @@ pje::engine::Sourceloader::Sourceloader() : m_primitives(),
 			std::cout << "[PJE] \tImporting fbx => primitive --- DONE" << std::endl;
 		}
 	}
+	/* m_primitives won't grow anymore => references stay valid */
+	m_registry = pje::engine::types::PrimitiveRegistry(m_primitives);
 }
 
 pje::engine::Sourceloader::~Sourceloader() {}
@@ -176,15 +179,13 @@ pje::engine::types::Mesh pje::engine::Sourceloader::meshAssimp2PJE(aiMesh* pMesh
 		throw std::runtime_error("Assimp mesh does not comply with engine's mesh!");
 	}
 
-	/* applying initial vertex transforms in parallel */
-	std::for_each(
-		std::execution::par_unseq,
-		vertices.begin(),
-		vertices.end(),
-		[&](pje::engine::types::Vertex& v) {
-			v.m_pos		= glm::vec3(nodeTransform * glm::vec4(v.m_pos, 1.0f)) * ANTI_FBX_SCALE;
-			v.m_normal	= glm::normalize(glm::transpose(glm::inverse(nodeTransform)) * glm::vec4(v.m_normal, 0.0f));
-		}
+	/* applying initial vertex transforms in SIMD batches | uniform ANTI_FBX_SCALE doesn't change normalized normals */
+	pje::engine::VertexKernel::transform(
+		vertices.data(),
+		vertices.data(),
+		vertices.size(),
+		glm::scale(glm::mat4(1.0f), glm::vec3(ANTI_FBX_SCALE)) * nodeTransform,
+		glm::uvec2(0, 0)
 	);
 
 	/* copying IBO | offset to prior vertices will be handled by OpenGL/Vulkan functions */
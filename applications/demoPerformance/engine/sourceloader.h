@@ -19,6 +19,7 @@
 
 /* Project Files */
 	#include "pjeBuffers.h"
+	#include "vertexKernel.h"
 
 namespace pje::engine {
 
@@ -28,6 +29,7 @@ namespace pje::engine {
 		std::vector<pje::engine::types::Primitive>	m_primitives;				// data
 		std::vector<std::string>					m_primitivePaths;			// m_primitivePaths[i] => m_primitives[i]
 		uint8_t										m_activePrimitivesCount;	// size(m_primitives)
+		pje::engine::types::PrimitiveRegistry		m_registry;					// m_primitives by PrimitiveKind => resolved after loading
 
 		Sourceloader();
 		~Sourceloader();
@@ -2,7 +2,7 @@
 //#define DEBUG
 
 /* PlantTurtle only works with an alphabet := "SLF-+[]" */
-pje::engine::PlantTurtle::PlantTurtle(std::string inputAlphabet) : TurtleInterpreter<pje::engine::types::Primitive>("SLF-+[]"), m_renderable() {
+pje::engine::PlantTurtle::PlantTurtle(std::string inputAlphabet) : TurtleInterpreter<pje::engine::types::PrimitiveRegistry>("SLF-+[]"), m_renderable(), m_priorWord(m_alphabet) {
 	std::string acceptedAlphabet = { m_alphabet };
 
 	/* sorting both alphabets to check for identicalness */
@@ -19,128 +19,899 @@ pje::engine::PlantTurtle::PlantTurtle(std::string inputAlphabet) : TurtleInterpr
 
 pje::engine::PlantTurtle::~PlantTurtle() {}
 
-void pje::engine::PlantTurtle::buildLSysObject(std::string lSysWord, const std::vector<pje::engine::types::Primitive>& primitives) {
-	/* resetting m_turtlePosMat and restpose-stack */
-	m_turtlePosMat = glm::mat4(1.0f);
-	while (!m_restposes.empty())
-		m_restposes.pop();
+pje::engine::PlantTurtle::BuildPrediction pje::engine::PlantTurtle::predictLSysObject(const pje::engine::LSysGenerator::WordPrediction& word, const pje::engine::types::PrimitiveRegistry& primitives) const {
+	BuildPrediction prediction = {};
 
-	/* resetting offsets */
-	m_offsetVCount = 0;
-	m_offsetICount = 0;
+	/* deploys primitive: LSysPrimitive views a copy of primitive's meshes inside of the arenas | instanced => 1 copy + count records */
+	auto deploy = [this, &prediction, &primitives](pje::engine::types::PrimitiveKind kind, uint64_t count) {
+		const pje::engine::types::Primitive& primitive = primitives.at(kind);
+		const uint64_t copies = m_buildMode == BuildMode::Instances ? 1 : count;
 
-	std::cout << "[PJE] \tBuilding Renderable (LSysObject) ..." << std::endl;
+		uint64_t bytes = sizeof(pje::engine::types::LSysPrimitive);
+		for (const auto& mesh : primitive.m_meshes) {
+			prediction.vertices	+= copies * mesh.m_vertices.size();
+			prediction.indices	+= copies * mesh.m_indices.size();
+			bytes += mesh.m_vertices.size() * sizeof(pje::engine::types::Vertex) + mesh.m_indices.size() * sizeof(uint32_t);
+		}
+
+		prediction.primitives	+= copies;
+		prediction.bytes		+= copies * bytes;
+
+		if (m_buildMode == BuildMode::Instances) {
+			prediction.instances	+= count;
+			prediction.bytes		+= count * sizeof(pje::engine::types::PrimitiveInstance);
+		}
+	};
+
+	/* ground and first bone are part of every LSysObject */
+	deploy(pje::engine::types::PrimitiveKind::Ground, 1);
+	deploy(pje::engine::types::PrimitiveKind::Stem, word.symbolCounts['S']);
+	deploy(pje::engine::types::PrimitiveKind::Leaf, word.symbolCounts['L']);
+	deploy(pje::engine::types::PrimitiveKind::Flower, word.symbolCounts['F']);
+
+	prediction.boneRefs = word.symbolCounts['S'] + word.symbolCounts['L'] + word.symbolCounts['F'];
+	prediction.bones	= 1 + word.symbolCounts['-'] + word.symbolCounts['+'];
+	prediction.bytes	+= prediction.boneRefs * sizeof(pje::engine::types::BoneRef) + prediction.bones * sizeof(pje::engine::types::Bone);
+
+	return prediction;
+}
+
+void pje::engine::PlantTurtle::reserveLSysObject(const BuildPrediction& prediction) {
+	m_reservation = prediction;
+}
+
+void pje::engine::PlantTurtle::setBuildMode(BuildMode mode) { m_buildMode = mode; }
+pje::engine::PlantTurtle::BuildMode pje::engine::PlantTurtle::getBuildMode() const { return m_buildMode; }
+void pje::engine::PlantTurtle::setInterpretation(Interpretation interpretation) { m_interpretation = interpretation; }
+pje::engine::PlantTurtle::Interpretation pje::engine::PlantTurtle::getInterpretation() const { return m_interpretation; }
+
+void pje::engine::PlantTurtle::buildLSysObject(const std::string& lSysWord, const pje::engine::types::PrimitiveRegistry& primitives) {
+	beginLSysObject(primitives, predictLSysObject(countCommands(lSysWord), primitives));
+
+	/* loops through all commands to generate m_renderable */
+	for (std::string::size_type i = 0; i < lSysWord.size(); i++) {
+		evaluateLSysCommand(lSysWord[i]);
+	}
+
+	endLSysObject();
+}
+
+void pje::engine::PlantTurtle::buildLSysObject(const pje::engine::PackedWord& lSysWord, const pje::engine::types::PrimitiveRegistry& primitives) {
+	beginLSysObject(primitives, predictLSysObject(countCommands(lSysWord), primitives));
+
+	if (m_interpretation == Interpretation::BranchParallel) {
+		buildBranchParallel(lSysWord);
+	}
+	else {
+		/* decodes every symbol inside of its 64 bit block */
+		lSysWord.forEachSymbol([this](char command) {
+			evaluateLSysCommand(command);
+		});
+	}
+
+	endLSysObject();
+}
+
+void pje::engine::PlantTurtle::buildLSysObject(pje::engine::LSysStream& lSysStream, const pje::engine::types::PrimitiveRegistry& primitives) {
+	/* stream can't be counted without deriving it twice => prediction of reserveLSysObject() */
+	beginLSysObject(primitives, m_reservation);
+
+	/* generator pushes every command into the turtle as soon as it is derived => word is never stored */
+	lSysStream.forEach([this](char command) {
+		evaluateLSysCommand(command);
+	});
+
+	endLSysObject();
+}
+
+void pje::engine::PlantTurtle::buildLSysObject(const pje::engine::LSysDag& lSysDag, const pje::engine::types::PrimitiveRegistry& primitives) {
+	beginLSysObject(primitives, predictLSysObject(countCommands(lSysDag), primitives));
+
+	/* depth-first walk over the leaves of lSysDag */
+	lSysDag.forEachSymbol([this](char command) {
+		evaluateLSysCommand(command);
+	});
+
+	endLSysObject();
+}
+
+void pje::engine::PlantTurtle::buildLSysObject(const pje::engine::LSysParametricWord& lSysWord, const pje::engine::types::PrimitiveRegistry& primitives) {
+	beginLSysObject(primitives, predictLSysObject(countCommands(lSysWord), primitives));
+
+	/* loops through all modules to generate m_renderable */
+	for (const auto& module : lSysWord.modules) {
+		evaluateLSysCommand(module.symbol, lSysWord.params.data() + module.firstParam, module.paramCount);
+	}
+
+	endLSysObject();
+}
+
+pje::engine::types::LSysObjectPatch pje::engine::PlantTurtle::rebuildLSysObject(const pje::engine::PackedWord& lSysWord, const pje::engine::types::PrimitiveRegistry& primitives) {
+	/* prior LSysObject can't be reused => every element is rewritten */
+	if (!m_priorValid || m_registry != &primitives || m_buildMode == BuildMode::Instances || lSysWord.getAlphabet() != m_priorWord.getAlphabet()) {
+		buildLSysObject(lSysWord, primitives);
+		m_priorWord		= lSysWord;
+		m_priorValid	= m_buildMode == BuildMode::Copies;
+
+		return pje::engine::types::LSysObjectPatch{
+			{ 0, static_cast<uint32_t>(m_renderable.m_vertices.size()) },
+			{ 0, static_cast<uint32_t>(m_renderable.m_indices.size()) },
+			{ 0, static_cast<uint32_t>(m_renderable.m_bones.size()) },
+			{ 0, static_cast<uint32_t>(m_renderable.m_boneRefs.size()) },
+			{ 0, static_cast<uint32_t>(m_renderable.m_instances.size()) },
+			true
+		};
+	}
+
+	/* diff by branch: first changed branch segment => every later element moves, so it is rewritten as well */
+	size_t shared = m_priorWord.commonPrefix(lSysWord);
+	if (shared < lSysWord.size()) {
+		while (shared > 0 && lSysWord.at(shared - 1) != '[' && lSysWord.at(shared - 1) != ']')
+			shared--;
+	}
+
+	std::cout << "[PJE] \tRebuilding Renderable (LSysObject) from symbol " << shared << " of " << lSysWord.size() << " ..." << std::endl;
+
+	/* keeps everything the shared branches deployed */
+	const BuildPrediction	sizes	= predictLSysObject(countCommands(lSysWord), primitives);
+	const BuildCounters		kept	= replayLSysObject(lSysWord, shared);
+
+	m_renderable.m_objectPrimitives.resize(kept.deployed);
+	m_renderable.m_boneRefs.resize(kept.boneRefs);
+	m_renderable.m_bones.resize(kept.bones);
+	m_renderable.m_objectPrimitives.reserve(sizes.primitives);
+	m_renderable.m_boneRefs.reserve(sizes.boneRefs);
+	m_renderable.m_bones.reserve(sizes.bones);
+	m_renderable.m_vertices.resize(sizes.vertices);
+	m_renderable.m_indices.resize(sizes.indices);
+	m_offsetVCount = kept.vertices;
+	m_offsetICount = kept.indices;
+
+	/* changed and appended branches */
+	const std::string& alphabet = lSysWord.getAlphabet();
+	lSysWord.forEachId(shared, lSysWord.size(), [this, &alphabet](uint8_t id) {
+		evaluateLSysCommand(alphabet[id]);
+	});
+
+	endLSysObject();
+	m_priorWord = lSysWord;
+
+	return pje::engine::types::LSysObjectPatch{
+		{ kept.vertices, static_cast<uint32_t>(m_renderable.m_vertices.size() - kept.vertices) },
+		{ kept.indices, static_cast<uint32_t>(m_renderable.m_indices.size() - kept.indices) },
+		{ kept.bones, static_cast<uint32_t>(m_renderable.m_bones.size() - kept.bones) },
+		{ kept.boneRefs, static_cast<uint32_t>(m_renderable.m_boneRefs.size() - kept.boneRefs) },
+		{ 0, 0 },
+		false
+	};
+}
+
+void pje::engine::PlantTurtle::buildBranchParallel(const pje::engine::PackedWord& lSysWord) {
+	enum class Command : uint8_t { Stem, Leaf, Flower, TiltLeft, TiltRight, Push, Pop, Invalid };
+
+	/* symbol id => command | same defaults as evaluateLSysCommand() without params */
+	std::array<Command, 256> commands;
+	commands.fill(Command::Invalid);
+	const std::string& alphabet = lSysWord.getAlphabet();
+	for (size_t id = 0; id < alphabet.size(); id++) {
+		switch (alphabet[id]) {
+		case 'S': commands[id] = Command::Stem;		break;
+		case 'L': commands[id] = Command::Leaf;		break;
+		case 'F': commands[id] = Command::Flower;	break;
+		case '-': commands[id] = Command::TiltLeft;	break;
+		case '+': commands[id] = Command::TiltRight;	break;
+		case '[': commands[id] = Command::Push;		break;
+		case ']': commands[id] = Command::Pop;		break;
+		}
+	}
+
+	const float					stemLength		= 0.2f;
+	const glm::vec3				translation		= glm::vec3(0.0f, stemLength, 0.0f);
+	const glm::quat				tilts[2]		= { tiltRotation(45.0f), tiltRotation(-45.0f) };
+	const pje::engine::types::PrimitiveKind sources[3] = {
+		pje::engine::types::PrimitiveKind::Stem, pje::engine::types::PrimitiveKind::Leaf, pje::engine::types::PrimitiveKind::Flower
+	};
+	size_t						sourceVertices[3];
+	size_t						sourceIndices[3];
+	for (size_t i = 0; i < 3; i++) {
+		countPrimitive(m_registry->at(sources[i]), sourceVertices[i], sourceIndices[i]);
+		/* instanced: arenas only hold the source primitives */
+		if (m_buildMode == BuildMode::Instances)
+			sourceVertices[i] = sourceIndices[i] = 0;
+	}
+
+	/* 1) nesting structure: word is cut at every bracket => counters of each segment equal the sequential build at its begin */
+	BuildCounters counters = {
+		static_cast<uint32_t>(m_buildMode == BuildMode::Instances ? m_renderable.m_instances.size() : m_renderable.m_objectPrimitives.size()),
+		static_cast<uint32_t>(m_renderable.m_boneRefs.size()),
+		static_cast<uint32_t>(m_renderable.m_bones.size()),
+		static_cast<uint32_t>(m_offsetVCount),
+		static_cast<uint32_t>(m_offsetICount)
+	};
+
+	std::vector<BranchSegment>	segments;
+	std::vector<uint32_t>		branchDepths	= { 0 };	// [branch] := bracket depth | branch 0 := whole word
+	std::vector<uint32_t>		openBranches	= { 0 };
+	std::vector<uint32_t>		openBones;				// bone of every open branch at its '['
+	uint32_t					bone			= m_branchBone;
+	BranchSegment				current			= { 0, 0, 0, -1, bone, counters };
+	size_t						position		= 0;
+
+	lSysWord.forEachId(0, lSysWord.size(), [&](uint8_t id) {
+		const Command command = commands[id];
+		switch (command) {
+		case Command::Stem:
+		case Command::Leaf:
+		case Command::Flower: {
+			const size_t source = static_cast<size_t>(command);
+			counters.deployed++;
+			counters.boneRefs++;
+			counters.vertices	+= static_cast<uint32_t>(sourceVertices[source]);
+			counters.indices	+= static_cast<uint32_t>(sourceIndices[source]);
+			break;
+		}
+		case Command::TiltLeft:
+		case Command::TiltRight:
+			bone = counters.bones++;
+			break;
+		case Command::Push: {
+			const uint32_t branch = static_cast<uint32_t>(branchDepths.size());
+			current.end			= position;
+			current.childBranch	= static_cast<int32_t>(branch);
+			segments.push_back(current);
+
+			branchDepths.push_back(branchDepths[openBranches.back()] + 1);
+			openBranches.push_back(branch);
+			openBones.push_back(bone);
+			openBranchNode(counters.deployed);
+			current = { position + 1, position + 1, branch, -1, bone, counters };
+			break;
+		}
+		case Command::Pop:
+			if (openBranches.size() == 1)
+				throw std::runtime_error("PlantTurtle received ']' without matching '['.");
 
-	/* lookup table for faster access to each primitive */
-	std::unordered_map<std::string, pje::engine::types::Primitive> primitiveSet;
-	const static std::array<std::string, 4> primitiveIdentifier = { "ground", "stem", "leaf", "flower" };
+			current.end = position;
+			segments.push_back(current);
 
+			openBranches.pop_back();
+			bone = openBones.back();
+			openBones.pop_back();
+			closeBranchNode(counters.deployed);
+			current = { position + 1, position + 1, openBranches.back(), -1, bone, counters };
+			break;
+		default:
+			std::cout << "[PJE] \tPlantTurtle received invalid command.\n";
+		}
+		position++;
+	});
+	current.end = position;
+	segments.push_back(current);
+	m_branchBone = bone;
+
+	/* 2) local transform of every segment relative to its begin */
+	std::vector<pje::engine::types::RigidTransform> transforms(segments.size());
 	std::for_each(
-		std::execution::par_unseq,
-		primitives.begin(),
-		primitives.end(),
-		[&primitiveSet](const pje::engine::types::Primitive& primitive) {
-			for (const auto& identifier : primitiveIdentifier) {
-				if (primitive.m_identifier.find(identifier) != std::string::npos) {
-					/* filling lookup table */
-					primitiveSet[identifier] = primitive;
-					break;
+		std::execution::par,
+		segments.begin(),
+		segments.end(),
+		[&](const BranchSegment& segment) {
+			pje::engine::types::RigidTransform local;
+			lSysWord.forEachId(segment.begin, segment.end, [&](uint8_t id) {
+				const Command command = commands[id];
+				if (command <= Command::Flower)
+					local = local.translated(translation);
+				else if (command <= Command::TiltRight)
+					local = local.rotated(tilts[command == Command::TiltLeft ? 0 : 1]);
+			});
+			transforms[&segment - segments.data()] = local;
+		}
+	);
+
+	/* segments of each branch (in word order) and branches of each depth => CSR tables */
+	const size_t branchCount = branchDepths.size();
+	const uint32_t maxDepth = *std::max_element(branchDepths.begin(), branchDepths.end());
+
+	std::vector<uint32_t> segmentOffsets(branchCount + 1, 0);
+	std::vector<uint32_t> branchSegments(segments.size());
+	for (const auto& segment : segments)
+		segmentOffsets[segment.branch + 1]++;
+	for (size_t branch = 0; branch < branchCount; branch++)
+		segmentOffsets[branch + 1] += segmentOffsets[branch];
+	{
+		std::vector<uint32_t> cursors(segmentOffsets.begin(), segmentOffsets.end() - 1);
+		for (size_t i = 0; i < segments.size(); i++)
+			branchSegments[cursors[segments[i].branch]++] = static_cast<uint32_t>(i);
+	}
+
+	std::vector<uint32_t> levelOffsets(maxDepth + 2, 0);
+	std::vector<uint32_t> levelBranches(branchCount);
+	for (const auto depth : branchDepths)
+		levelOffsets[depth + 1]++;
+	for (size_t depth = 0; depth <= maxDepth; depth++)
+		levelOffsets[depth + 1] += levelOffsets[depth];
+	{
+		std::vector<uint32_t> cursors(levelOffsets.begin(), levelOffsets.end() - 1);
+		for (size_t branch = 0; branch < branchCount; branch++)
+			levelBranches[cursors[branchDepths[branch]]++] = static_cast<uint32_t>(branch);
+	}
+
+	/* 3) scan of transforms per depth: a branch starts with the turtle matrix of its '[' => transforms[] := absolute matrix at segment begin */
+	std::vector<pje::engine::types::RigidTransform> branchStarts(branchCount);
+	branchStarts[0] = m_turtlePose;
+	const uint32_t lastSegment = static_cast<uint32_t>(segments.size() - 1);
+
+	for (size_t depth = 0; depth <= maxDepth; depth++) {
+		std::for_each(
+			std::execution::par,
+			levelBranches.begin() + levelOffsets[depth],
+			levelBranches.begin() + levelOffsets[depth + 1],
+			[&](uint32_t branch) {
+				pje::engine::types::RigidTransform turtle = branchStarts[branch];
+				for (uint32_t i = segmentOffsets[branch]; i < segmentOffsets[branch + 1]; i++) {
+					const uint32_t segment = branchSegments[i];
+					const pje::engine::types::RigidTransform local = transforms[segment];
+
+					transforms[segment]	= turtle;
+					turtle				= turtle * local;
+
+					if (segments[segment].childBranch >= 0)
+						branchStarts[segments[segment].childBranch] = turtle;
+					/* turtle of the last symbol => equals Sequential */
+					if (segment == lastSegment)
+						m_turtlePose = turtle;
 				}
 			}
+		);
+	}
+
+	/* 4) every segment writes into its own slots => containers are sized once */
+	if (m_buildMode == BuildMode::Instances)
+		m_renderable.m_instances.resize(counters.deployed);
+	else
+		m_renderable.m_objectPrimitives.resize(counters.deployed);
+	m_renderable.m_boneRefs.resize(counters.boneRefs);
+	m_renderable.m_bones.resize(counters.bones);
+	m_renderable.m_vertices.resize(counters.vertices);
+	m_renderable.m_indices.resize(counters.indices);
+	m_offsetVCount = counters.vertices;
+	m_offsetICount = counters.indices;
+
+	std::for_each(
+		std::execution::par,
+		segments.begin(),
+		segments.end(),
+		[&](const BranchSegment& segment) {
+			pje::engine::types::RigidTransform	turtle	= transforms[&segment - segments.data()];
+			BuildCounters						slot	= segment.counters;
+			uint32_t							bone	= segment.bone;
+			const uint32_t						depth	= branchDepths[segment.branch];
+
+			lSysWord.forEachId(segment.begin, segment.end, [&](uint8_t id) {
+				const Command command = commands[id];
+				if (command <= Command::Flower) {
+					const size_t source = static_cast<size_t>(command);
+
+					/* same BoneRef as createRef(): latest bone of this branch */
+					m_renderable.m_boneRefs[slot.boneRefs] = pje::engine::types::BoneRef{ bone, 1.0f };
+					placePrimitive(sources[source], turtle.toMat4(), slot, slot.boneRefs, 1, depth);
+					turtle = turtle.translated(translation);
+
+					slot.deployed++;
+					slot.boneRefs++;
+					slot.vertices	+= static_cast<uint32_t>(sourceVertices[source]);
+					slot.indices	+= static_cast<uint32_t>(sourceIndices[source]);
+				}
+				else if (command <= Command::TiltRight) {
+					turtle = turtle.rotated(tilts[command == Command::TiltLeft ? 0 : 1]);
+					m_renderable.m_bones[slot.bones] = createBone(turtle, bone);
+					bone = slot.bones++;
+				}
+			});
 		}
 	);
+}
+
+pje::engine::LSysGenerator::WordPrediction pje::engine::PlantTurtle::countCommands(const std::string& lSysWord) {
+	pje::engine::LSysGenerator::WordPrediction counts = { lSysWord.size(), {} };
+	for (const char command : lSysWord)
+		counts.symbolCounts[static_cast<uint8_t>(command)]++;
+
+	return counts;
+}
+
+pje::engine::LSysGenerator::WordPrediction pje::engine::PlantTurtle::countCommands(const pje::engine::PackedWord& lSysWord) {
+	/* counts ids without decoding them => characters afterwards */
+	std::array<uint64_t, 256> idCounts = {};
+	lSysWord.forEachId(0, lSysWord.size(), [&idCounts](uint8_t id) {
+		idCounts[id]++;
+	});
+
+	pje::engine::LSysGenerator::WordPrediction counts = { lSysWord.size(), {} };
+	const std::string& alphabet = lSysWord.getAlphabet();
+	for (size_t id = 0; id < alphabet.size(); id++)
+		counts.symbolCounts[static_cast<uint8_t>(alphabet[id])] += idCounts[id];
+
+	return counts;
+}
+
+pje::engine::LSysGenerator::WordPrediction pje::engine::PlantTurtle::countCommands(const pje::engine::LSysDag& lSysDag) {
+	/* every node of lSysDag caches its counts => no walk */
+	pje::engine::LSysGenerator::WordPrediction counts = { lSysDag.getLength(), {} };
+	for (const char command : std::string("SLF-+[]"))
+		counts.symbolCounts[static_cast<uint8_t>(command)] = lSysDag.getSymbolCount(command);
+
+	return counts;
+}
+
+pje::engine::LSysGenerator::WordPrediction pje::engine::PlantTurtle::countCommands(const pje::engine::LSysParametricWord& lSysWord) {
+	pje::engine::LSysGenerator::WordPrediction counts = { lSysWord.modules.size(), {} };
+	for (const auto& module : lSysWord.modules)
+		counts.symbolCounts[static_cast<uint8_t>(module.symbol)]++;
+
+	return counts;
+}
+
+void pje::engine::PlantTurtle::beginLSysObject(const pje::engine::types::PrimitiveRegistry& primitives, const BuildPrediction& sizes) {
+	/* resetting m_turtlePose and restpose-stack */
+	m_turtlePose = pje::engine::types::RigidTransform();
+	while (!m_restposes.empty())
+		m_restposes.pop();
+	m_branchBone = pje::engine::types::Bone::root;
+	while (!m_branchBones.empty())
+		m_branchBones.pop();
+
+	/* resetting offsets */
+	m_offsetVCount = 0;
+	m_offsetICount = 0;
+
+	std::cout << "[PJE] \tBuilding Renderable (LSysObject) ..." << std::endl;
+
+	/* registry outlives this build => no lookup table, no copies of primitives */
+	m_registry = &primitives;
+	/* m_renderable won't match m_priorWord anymore */
+	m_priorValid = false;
 
 	/* cleanup of m_renderable for this build */
 	m_renderable.m_objectPrimitives.clear();
+	m_renderable.m_vertices.clear();
+	m_renderable.m_indices.clear();
 	m_renderable.m_bones.clear();
 	m_renderable.m_boneRefs.clear();
+	m_renderable.m_instances.clear();
+	m_renderable.m_instanceRanges.clear();
+	m_renderable.m_instanceBounds.clear();
+	m_renderable.m_branchNodes.clear();
 	m_renderable.m_matrices = {};
-	m_renderable.m_choosenTexture = primitives[0].m_texture;	// PROJECT LIMITATION: same texture map for all primitives
+	m_renderable.m_choosenTexture = primitives.at(pje::engine::types::PrimitiveKind::Ground).m_texture;	// PROJECT LIMITATION: same texture map for all primitives
 
-	/* first bone of m_renderable */
+	/* containers are sized once => arenas are written at the offsets of each LSysPrimitive */
+	m_renderable.m_objectPrimitives.reserve(sizes.primitives);
+	m_renderable.m_bones.reserve(sizes.bones);
+	m_renderable.m_boneRefs.reserve(sizes.boneRefs);
+	m_renderable.m_instances.reserve(sizes.instances);
+	m_renderable.m_vertices.resize(sizes.vertices);
+	m_renderable.m_indices.resize(sizes.indices);
+
+	/* instanced: every source primitive is stored once in primitive space */
+	m_sourceIds.fill(0);
+	if (m_buildMode == BuildMode::Instances) {
+		for (size_t kind = 0; kind < m_sourceIds.size(); kind++) {
+			const pje::engine::types::Primitive& source = primitives.at(static_cast<pje::engine::types::PrimitiveKind>(kind));
+			m_sourceIds[kind] = static_cast<uint32_t>(m_renderable.m_objectPrimitives.size());
+			writePrimitive(source, appendPrimitive(source, 0), glm::mat4(1.0f), 0, 0);
+		}
+	}
+
+	/* first bone of m_renderable := root of the skeleton */
 	m_renderable.m_bones.push_back(createBone());
 
+	/* root of the branch BVH := whole LSysObject */
+	m_openNodes.clear();
+	openBranchNode(0);
+
 	/* optional ground primitive */
-	deployPrimitive(primitiveSet.at("ground"), glm::vec3(0.0f), false);
+	deployPrimitive(pje::engine::types::PrimitiveKind::Ground, glm::vec3(0.0f), false);
+}
+
+pje::engine::PlantTurtle::BuildCounters pje::engine::PlantTurtle::replayLSysObject(const pje::engine::PackedWord& lSysWord, size_t end) {
+	/* same defaults as evaluateLSysCommand() without params */
+	const float		stemLength	= 0.2f;
+	const glm::quat	tilts[2]	= { tiltRotation(45.0f), tiltRotation(-45.0f) };
+
+	/* sizes right after beginLSysObject(): ground primitive and first bone */
+	size_t vertices;
+	size_t indices;
+	countPrimitive(m_registry->at(pje::engine::types::PrimitiveKind::Ground), vertices, indices);
+	BuildCounters counters = { 1, 0, 1, static_cast<uint32_t>(vertices), static_cast<uint32_t>(indices) };
+
+	m_turtlePose = pje::engine::types::RigidTransform();
+	while (!m_restposes.empty())
+		m_restposes.pop();
+	m_branchBone = 0;
+	while (!m_branchBones.empty())
+		m_branchBones.pop();
+
+	/* branch BVH of the kept branches => nodes of the evaluated ones are appended */
+	m_renderable.m_branchNodes.clear();
+	m_openNodes.clear();
+	openBranchNode(0);
+
+	const std::string& alphabet = lSysWord.getAlphabet();
+	lSysWord.forEachId(0, end, [&](uint8_t id) {
+		pje::engine::types::PrimitiveKind kind;
+		switch (alphabet[id]) {
+		case 'S': kind = pje::engine::types::PrimitiveKind::Stem;	break;
+		case 'L': kind = pje::engine::types::PrimitiveKind::Leaf;	break;
+		case 'F': kind = pje::engine::types::PrimitiveKind::Flower;	break;
+		case '-':
+			m_turtlePose = m_turtlePose.rotated(tilts[0]);
+			m_branchBone = counters.bones++;
+			return;
+		case '+':
+			m_turtlePose = m_turtlePose.rotated(tilts[1]);
+			m_branchBone = counters.bones++;
+			return;
+		case '[':
+			m_restposes.push(m_turtlePose);
+			m_branchBones.push(m_branchBone);
+			openBranchNode(counters.deployed);
+			return;
+		case ']':
+			m_turtlePose = m_restposes.top();
+			m_restposes.pop();
+			m_branchBone = m_branchBones.top();
+			m_branchBones.pop();
+			closeBranchNode(counters.deployed);
+			return;
+		default:
+			return;
+		}
+
+		countPrimitive(m_registry->at(kind), vertices, indices);
+		counters.deployed++;
+		counters.boneRefs++;
+		counters.vertices	+= static_cast<uint32_t>(vertices);
+		counters.indices	+= static_cast<uint32_t>(indices);
+		m_turtlePose = m_turtlePose.translated(glm::vec3(0.0f, stemLength, 0.0f));
+	});
+
+	return counters;
+}
+
+void pje::engine::PlantTurtle::endLSysObject() {
+	/* arenas of a reserved stream may be larger than its word */
+	m_renderable.m_vertices.resize(m_offsetVCount);
+	m_renderable.m_indices.resize(m_offsetICount);
 
-	/* loops through all commands to generate m_renderable */
-	for (std::string::size_type i = 0; i < lSysWord.size(); i++) {
-		evaluateLSysCommand(lSysWord[i], primitiveSet);
-	}
 #ifdef DEBUG
-	std::cout << "[PJE] \tColumns of final m_turtlePosMat:\n\t" << glm::to_string(m_turtlePosMat) << std::endl;
+	std::cout << "[PJE] \tColumns of final m_turtlePose:\n\t" << glm::to_string(m_turtlePose.toMat4()) << std::endl;
 #endif // DEBUG
+
+	/* branch BVH: unclosed branches end with the word */
+	while (!m_openNodes.empty())
+		closeBranchNode(countDeployed());
+	boundBranchNodes();
+
+	/* instanced: counting sort by primitiveId => 1 draw per mesh of every source primitive */
+	if (m_buildMode == BuildMode::Instances) {
+		auto& ranges = m_renderable.m_instanceRanges;
+		ranges.assign(m_renderable.m_objectPrimitives.size(), pje::engine::types::InstanceRange{ 0, 0 });
+		for (const auto& instance : m_renderable.m_instances)
+			ranges[instance.primitiveId].count++;
+		for (size_t id = 1; id < ranges.size(); id++)
+			ranges[id].first = ranges[id - 1].first + ranges[id - 1].count;
+
+		const auto& instances = m_renderable.m_instances;
+		std::vector<uint32_t> order(instances.size());
+		std::vector<uint32_t> cursors(ranges.size());
+		for (size_t id = 0; id < ranges.size(); id++)
+			cursors[id] = ranges[id].first;
+		for (uint32_t i = 0; i < instances.size(); i++)
+			order[cursors[instances[i].primitiveId]++] = i;
+
+		/* shallow instances first => every LSysLod draws a prefix of each range */
+		for (const auto& range : ranges) {
+			std::stable_sort(
+				order.begin() + range.first,
+				order.begin() + range.first + range.count,
+				[&instances](uint32_t a, uint32_t b) { return instances[a].depth < instances[b].depth; }
+			);
+		}
+
+		/* AABBs of boundBranchNodes() follow their instances */
+		std::vector<pje::engine::types::PrimitiveInstance>	grouped(instances.size());
+		std::vector<pje::engine::types::InstanceBounds>		groupedBounds(instances.size());
+		for (size_t i = 0; i < order.size(); i++) {
+			grouped[i]			= instances[order[i]];
+			groupedBounds[i]	= m_renderable.m_instanceBounds[order[i]];
+		}
+		m_renderable.m_instances.swap(grouped);
+		m_renderable.m_instanceBounds.swap(groupedBounds);
+	}
+
+	/* LOD chain of a prior build doesn't match m_renderable anymore => buildLodChain() */
+	m_renderable.m_lods.clear();
+	m_renderable.m_bounds = glm::vec4(0.0f);
+
+	/* quantized copy of a prior build is stale => compactVertices() */
+	m_renderable.m_compactVertices.clear();
+
+	/* BoneMatrices of all m_bones => uploaded as a whole */
+	m_renderable.resetBonePalette();
+
 	std::cout << 
 		"[PJE] \tBuilding Renderable (LSysObject) --- DONE" << 
 		"\n\tPrimitives inside of Renderable : \t" << m_renderable.m_objectPrimitives.size() << 
+		"\n\tInstances inside of Renderable : \t" << m_renderable.m_instances.size() << 
+		"\n\tVertices inside of Renderable : \t" << m_renderable.m_vertices.size() << 
+		"\n\tIndices inside of Renderable : \t" << m_renderable.m_indices.size() << 
 		"\n\tBones inside of Renderable : \t\t" << m_renderable.m_bones.size() <<
 		"\n\tBoneRefs inside of Renderable : \t" << m_renderable.m_boneRefs.size() << "\n" <<
 	std::endl;
 }
 
-void pje::engine::PlantTurtle::evaluateLSysCommand(const char& command, const std::unordered_map<std::string, pje::engine::types::Primitive>& primitiveSet) {
+void pje::engine::PlantTurtle::openBranchNode(uint32_t deployed) {
+	/* root := depth 0 | every open node := 1 bracket */
+	const uint32_t depth = static_cast<uint32_t>(m_openNodes.size());
+
+	m_openNodes.push_back(static_cast<uint32_t>(m_renderable.m_branchNodes.size()));
+	m_renderable.m_branchNodes.push_back(pje::engine::types::LSysBranchNode{
+		glm::vec3(std::numeric_limits<float>::max()), 0.0f, glm::vec3(std::numeric_limits<float>::lowest()), depth, deployed, 0, 0, depth, 0
+	});
+}
+
+void pje::engine::PlantTurtle::closeBranchNode(uint32_t deployed) {
+	auto& node = m_renderable.m_branchNodes[m_openNodes.back()];
+	node.deployedCount	= deployed - node.firstDeployed;
+	node.skip			= static_cast<uint32_t>(m_renderable.m_branchNodes.size());
+	m_openNodes.pop_back();
+
+	if (!m_openNodes.empty()) {
+		auto& parent = m_renderable.m_branchNodes[m_openNodes.back()];
+		parent.maxDepth = std::max(parent.maxDepth, node.maxDepth);
+	}
+}
+
+uint32_t pje::engine::PlantTurtle::countDeployed() const {
+	return static_cast<uint32_t>(m_buildMode == BuildMode::Instances ? m_renderable.m_instances.size() : m_renderable.m_objectPrimitives.size());
+}
+
+void pje::engine::PlantTurtle::boundBranchNodes() {
+	const auto&	bones		= m_renderable.m_bones;
+	const auto&	boneRefs	= m_renderable.m_boneRefs;
+	const bool	instanced	= m_buildMode == BuildMode::Instances;
+
+	/* path from the root bone along the chain of every bone | bones on that chain => parents are created before their children */
+	std::vector<float>		chainLengths(bones.size(), 0.0f);
+	std::vector<uint32_t>	chainBones(bones.size(), 1);
+	for (size_t bone = 0; bone < bones.size(); bone++) {
+		const uint32_t parent = bones[bone].parent;
+		if (parent == pje::engine::types::Bone::root)
+			continue;
+
+		chainLengths[bone]	= chainLengths[parent] + glm::length(bones[bone].restpose.translation - bones[parent].restpose.translation);
+		chainBones[bone]	= chainBones[parent] + 1;
+	}
+
+	/* AABB, wind lever and wind chain of every deployed primitive in deploy order */
+	const size_t deployed = countDeployed();
+	std::vector<glm::vec3>	mins(deployed, glm::vec3(std::numeric_limits<float>::max()));
+	std::vector<glm::vec3>	maxs(deployed, glm::vec3(std::numeric_limits<float>::lowest()));
+	std::vector<float>		levers(deployed, 0.0f);
+	std::vector<uint32_t>	chains(deployed, 0);
+
+	auto leverOf = [&](const glm::vec3& position, glm::uint boneRefOffset, glm::uint boneRefCount, uint32_t& chain) {
+		float lever = 0.0f;
+		for (glm::uint ref = boneRefOffset; ref < boneRefOffset + boneRefCount; ref++) {
+			const uint32_t bone = boneRefs[ref].boneId;
+			lever	= std::max(lever, chainLengths[bone] + glm::length(position - bones[bone].restpose.translation));
+			chain	= std::max(chain, chainBones[bone]);
+		}
+		return lever;
+	};
+
+	if (instanced) {
+		/* AABB of every source primitive in primitive space */
+		std::vector<glm::vec3> sourceMins(m_renderable.m_objectPrimitives.size(), glm::vec3(std::numeric_limits<float>::max()));
+		std::vector<glm::vec3> sourceMaxs(m_renderable.m_objectPrimitives.size(), glm::vec3(std::numeric_limits<float>::lowest()));
+		for (size_t id = 0; id < m_renderable.m_objectPrimitives.size(); id++) {
+			const auto& view = m_renderable.m_objectPrimitives[id];
+			for (uint32_t v = view.firstVertex; v < view.firstVertex + view.vertexCount; v++) {
+				sourceMins[id] = glm::min(sourceMins[id], m_renderable.m_vertices[v].m_pos);
+				sourceMaxs[id] = glm::max(sourceMaxs[id], m_renderable.m_vertices[v].m_pos);
+			}
+		}
+
+		/* corners of its source => object space */
+		for (size_t i = 0; i < deployed; i++) {
+			const auto& instance = m_renderable.m_instances[i];
+			if (sourceMins[instance.primitiveId].x > sourceMaxs[instance.primitiveId].x)
+				continue;
+
+			for (int corner = 0; corner < 8; corner++) {
+				const glm::vec3 local(
+					(corner & 1) ? sourceMaxs[instance.primitiveId].x : sourceMins[instance.primitiveId].x,
+					(corner & 2) ? sourceMaxs[instance.primitiveId].y : sourceMins[instance.primitiveId].y,
+					(corner & 4) ? sourceMaxs[instance.primitiveId].z : sourceMins[instance.primitiveId].z
+				);
+				const glm::vec3 position = glm::vec3(instance.transform * glm::vec4(local, 1.0f));
+				mins[i]		= glm::min(mins[i], position);
+				maxs[i]		= glm::max(maxs[i], position);
+				levers[i]	= std::max(levers[i], leverOf(position, instance.boneRefId, instance.boneRefCount, chains[i]));
+			}
+		}
+
+		/* every instance is culled on its own => LSysObject::cullInstances() */
+		m_renderable.m_instanceBounds.resize(deployed);
+		for (size_t i = 0; i < deployed; i++)
+			m_renderable.m_instanceBounds[i] = pje::engine::types::InstanceBounds{ mins[i], levers[i], maxs[i], chains[i] };
+	}
+	else {
+		std::for_each(
+			std::execution::par,
+			m_renderable.m_objectPrimitives.begin(),
+			m_renderable.m_objectPrimitives.end(),
+			[&](const pje::engine::types::LSysPrimitive& view) {
+				const size_t i = &view - m_renderable.m_objectPrimitives.data();
+				for (uint32_t v = view.firstVertex; v < view.firstVertex + view.vertexCount; v++) {
+					const auto& vertex = m_renderable.m_vertices[v];
+					mins[i]		= glm::min(mins[i], vertex.m_pos);
+					maxs[i]		= glm::max(maxs[i], vertex.m_pos);
+					levers[i]	= std::max(levers[i], leverOf(vertex.m_pos, vertex.m_boneAttrib.x, vertex.m_boneAttrib.y, chains[i]));
+				}
+			}
+		);
+	}
+
+	/* node := union of its range (sub-branches included) */
+	std::for_each(
+		std::execution::par,
+		m_renderable.m_branchNodes.begin(),
+		m_renderable.m_branchNodes.end(),
+		[&](pje::engine::types::LSysBranchNode& node) {
+			for (uint32_t i = node.firstDeployed; i < node.firstDeployed + node.deployedCount; i++) {
+				node.min		= glm::min(node.min, mins[i]);
+				node.max		= glm::max(node.max, maxs[i]);
+				node.windLever	= std::max(node.windLever, levers[i]);
+				node.windChain	= std::max(node.windChain, chains[i]);
+			}
+		}
+	);
+}
+
+void pje::engine::PlantTurtle::buildLodChain(uint32_t levels) {
+	m_renderable.m_lods.clear();
+	if (levels == 0)
+		return;
+
+	const bool instanced = m_renderable.isInstanced();
+
+	/* deepest branch of m_renderable | bounding sphere around all deployed vertices */
+	uint32_t	maxDepth = 0;
+	glm::vec3	minCorner(std::numeric_limits<float>::max());
+	glm::vec3	maxCorner(std::numeric_limits<float>::lowest());
+	float		sourceRadius = 0.0f;
+
+	if (instanced) {
+		/* source primitives are stored in primitive space => largest source extent pads every instance translation */
+		for (const auto& vertex : m_renderable.m_vertices)
+			sourceRadius = std::max(sourceRadius, glm::length(vertex.m_pos));
+		for (const auto& instance : m_renderable.m_instances) {
+			maxDepth	= std::max(maxDepth, instance.depth);
+			minCorner	= glm::min(minCorner, glm::vec3(instance.transform[3]));
+			maxCorner	= glm::max(maxCorner, glm::vec3(instance.transform[3]));
+		}
+	}
+	else {
+		for (const auto& primitive : m_renderable.m_objectPrimitives)
+			maxDepth = std::max(maxDepth, primitive.depth);
+		for (const auto& vertex : m_renderable.m_vertices) {
+			minCorner = glm::min(minCorner, vertex.m_pos);
+			maxCorner = glm::max(maxCorner, vertex.m_pos);
+		}
+	}
+
+	if (minCorner.x <= maxCorner.x) {
+		const glm::vec3 center = 0.5f * (minCorner + maxCorner);
+		m_renderable.m_bounds = glm::vec4(center, glm::length(maxCorner - center) + sourceRadius);
+	}
+
+	/* LOD i keeps branches up to maxDepth * (levels - 1 - i) / (levels - 1) => last LOD := trunk only */
+	for (uint32_t level = 0; level < levels; level++) {
+		pje::engine::types::LSysLod lod = {};
+		lod.maxDepth		= levels == 1 ? maxDepth : maxDepth * (levels - 1 - level) / (levels - 1);
+		lod.minScreenSize	= level + 1 == levels ? 0.0f : 0.5f / static_cast<float>(1u << level);
+
+		if (instanced) {
+			/* instances are sorted by depth per source => prefix of every range */
+			lod.instanceRanges = m_renderable.m_instanceRanges;
+			for (size_t id = 0; id < lod.instanceRanges.size(); id++) {
+				auto&				range	= lod.instanceRanges[id];
+				const uint32_t		end		= range.first + range.count;
+				uint32_t			count	= 0;
+				while (range.first + count < end && m_renderable.m_instances[range.first + count].depth <= lod.maxDepth)
+					count++;
+				range.count		= count;
+				lod.triangles	+= uint64_t(count) * (m_renderable.m_objectPrimitives[id].indexCount / 3);
+			}
+		}
+		else {
+			for (const auto& primitive : m_renderable.m_objectPrimitives) {
+				if (primitive.depth > lod.maxDepth)
+					continue;
+				lod.primitives.push_back(primitive);
+				lod.triangles += primitive.indexCount / 3;
+			}
+		}
+
+		m_renderable.m_lods.push_back(std::move(lod));
+	}
+
+	std::cout << "[PJE] \tLOD chain of Renderable (LSysObject) | bounding radius " << m_renderable.m_bounds.w << " :\n";
+	for (size_t level = 0; level < m_renderable.m_lods.size(); level++) {
+		const auto& lod = m_renderable.m_lods[level];
+		std::cout <<
+			"\tLOD " << level << " : \tdepth <= " << lod.maxDepth << " | " <<
+			(instanced ? lod.instanceRanges.size() : lod.primitives.size()) << " draws | " <<
+			lod.triangles << " triangles | screen size >= " << lod.minScreenSize << "\n";
+	}
+	std::cout << std::endl;
+}
+
+void pje::engine::PlantTurtle::evaluateLSysCommand(const char& command, const float* params, uint8_t paramCount) {
+	/* default height of a stem | default tilt */
+	const float stemLength	= 0.2f;
+	const float degrees		= paramCount > 0 ? params[0] : 45.0f;
+	const float scale		= paramCount > 0 ? params[0] : 1.0f;
+
 	/* actual evaluation of given command */
 	switch (command) {
 	case 'S':
-		deployPrimitive(primitiveSet.at("stem"), glm::vec3(0.0f, 0.2f, 0.0f), true);
+		/* S(length): stem is stretched along its local y axis */
+		if (paramCount > 0)
+			deployPrimitive(pje::engine::types::PrimitiveKind::Stem, glm::vec3(0.0f, params[0], 0.0f), true, glm::vec3(1.0f, params[0] / stemLength, 1.0f));
+		else
+			deployPrimitive(pje::engine::types::PrimitiveKind::Stem, glm::vec3(0.0f, stemLength, 0.0f), true);
 		break;
 	case 'L':
-		deployPrimitive(primitiveSet.at("leaf"), glm::vec3(0.0f, 0.2f, 0.0f), true);
+		deployPrimitive(pje::engine::types::PrimitiveKind::Leaf, glm::vec3(0.0f, stemLength * scale, 0.0f), true, glm::vec3(scale));
 		break;
 	case 'F':
-		deployPrimitive(primitiveSet.at("flower"), glm::vec3(0.0f, 0.2f, 0.0f), true);
+		deployPrimitive(pje::engine::types::PrimitiveKind::Flower, glm::vec3(0.0f, stemLength * scale, 0.0f), true, glm::vec3(scale));
 		break;
 	case '-':
 		/* Assumption: tilting to left */
-		tiltTurtle(45.0f);
+		tiltTurtle(degrees);
 		/* new bone after tilting */
 		m_renderable.m_bones.push_back(createBone());
 		break;
 	case '+':
 		/* Assumption: tilting to right */
-		tiltTurtle(-45.0f);
+		tiltTurtle(-degrees);
 		/* new bone after tilting */
 		m_renderable.m_bones.push_back(createBone());
 		break;
 	case '[':
-		/* saving current turtle position for fallback */
-		m_restposes.push(m_turtlePosMat);
+		/* saving current turtle position and bone for fallback */
+		m_restposes.push(m_turtlePose);
+		m_branchBones.push(m_branchBone);
+		openBranchNode(countDeployed());
 		break;
 	case ']':
-		/* fallback to last remembered turtle position */
-		m_turtlePosMat = m_restposes.top();
+		/* fallback to last remembered turtle position and bone */
+		m_turtlePose = m_restposes.top();
 		m_restposes.pop();
+		m_branchBone = m_branchBones.top();
+		m_branchBones.pop();
+		closeBranchNode(countDeployed());
 		break;
 	default:
 		std::cout << "[PJE] \tPlantTurtle received invalid command.\n";
 	}
 }
 
-void pje::engine::PlantTurtle::deployPrimitive(const pje::engine::types::Primitive& primitive, const glm::vec3& postTurtleTranslation, bool needsBoneRef) {
-	/* create new LSysPrimitive for m_renderable */
-	pje::engine::types::LSysPrimitive currentLSysPrimitive;
-	currentLSysPrimitive.m_identifier						= primitive.m_identifier;
-	currentLSysPrimitive.m_texture							= primitive.m_texture;
-	currentLSysPrimitive.m_offsetPriorPrimitivesVertices	= m_offsetVCount;
-	currentLSysPrimitive.m_offsetPriorPrimitivesIndices		= m_offsetICount;
-	currentLSysPrimitive.m_meshes							= primitive.m_meshes;
-
-	/* update PlantTurtle's offsets for next call of deployPrimitive() */
-	if (primitive.m_meshes.size() > 1) {
-		m_offsetVCount += (
-			primitive.m_meshes[primitive.m_meshes.size() - 2].m_offsetPriorMeshesVertices +		// vertex count of all prior meshes to last mesh +
-			primitive.m_meshes[primitive.m_meshes.size() - 1].m_vertices.size()					// vertex count of last mesh
-			);
-		m_offsetICount += (
-			primitive.m_meshes[primitive.m_meshes.size() - 2].m_offsetPriorMeshesIndices +		// index count of all prior meshes to last mesh +
-			primitive.m_meshes[primitive.m_meshes.size() - 1].m_indices.size()					// index count of last mesh
-			);
-	}
-	else {
-		m_offsetVCount += primitive.m_meshes[0].m_vertices.size();
-		m_offsetICount += primitive.m_meshes[0].m_indices.size();
-	}
-
+void pje::engine::PlantTurtle::deployPrimitive(pje::engine::types::PrimitiveKind kind, const glm::vec3& postTurtleTranslation, bool needsBoneRef, const glm::vec3& scale) {
 	/* creates BoneRef and an offset for the primitive's vertices to access the right BoneRef in shader */
 	glm::uint offset;
 	glm::uint count;
@@ -157,63 +928,140 @@ void pje::engine::PlantTurtle::deployPrimitive(const pje::engine::types::Primiti
 		count	= 0;
 	}
 
-	/* vertex: primitive space => model space */
-	for (auto& mesh : currentLSysPrimitive.m_meshes) {
-		std::for_each(
-			std::execution::par_unseq,
-			mesh.m_vertices.begin(),
-			mesh.m_vertices.end(),
-			[&](pje::engine::types::Vertex& v) {
-				// vertex to model space: O_i * v
-				v.m_pos			= glm::vec3(m_turtlePosMat * glm::vec4(v.m_pos, 1.0f));
-				// adjusting normal after transforming normal
-				v.m_normal		= glm::normalize(glm::transpose(glm::inverse(m_turtlePosMat)) * glm::vec4(v.m_normal, 0.0f));
-				// uvec2(<first relevant boneRef>, <boneRefsCount for this vertex>) | 
-				v.m_boneAttrib	= glm::uvec2(offset, count);
-			}
-		);
-	}
+	/* primitive space => model space | scale only affects this primitive, not the turtle */
+	const glm::mat4 modelMat	= glm::scale(m_turtlePose.toMat4(), scale);
+	/* open brackets := nesting depth of the current branch */
+	const uint32_t	depth		= static_cast<uint32_t>(m_restposes.size());
 
-	m_renderable.m_objectPrimitives.push_back(currentLSysPrimitive);
+	if (m_buildMode == BuildMode::Instances) {
+		/* record only => source primitive is transformed by the vertex shader */
+		m_renderable.m_instances.push_back(pje::engine::types::PrimitiveInstance{
+			modelMat, m_sourceIds[static_cast<size_t>(kind)], offset, count, depth
+		});
+	}
+	else {
+		const pje::engine::types::Primitive& primitive = m_registry->at(kind);
+		writePrimitive(primitive, appendPrimitive(primitive, depth), modelMat, offset, count);
+	}
 
-	/* local translation: m_turtlePosMat * postTurtleTranslation */
-	m_turtlePosMat = glm::translate(m_turtlePosMat, postTurtleTranslation);
+	/* local translation: m_turtlePose * postTurtleTranslation */
+	m_turtlePose = m_turtlePose.translated(postTurtleTranslation);
 #ifdef DEBUG
-	std::cout << "[GLM] \tColumns of m_turtlePosMat after deployPrimitive:\n\t" << glm::to_string(m_turtlePosMat) << std::endl;
+	std::cout << "[GLM] \tColumns of m_turtlePose after deployPrimitive:\n\t" << glm::to_string(m_turtlePose.toMat4()) << std::endl;
 #endif // DEBUG
 }
 
-void pje::engine::PlantTurtle::tiltTurtle(float degrees) {
-	glm::mat4 rotation = glm::mat4(1.0f);
+pje::engine::types::LSysPrimitive pje::engine::PlantTurtle::appendPrimitive(const pje::engine::types::Primitive& primitive, uint32_t depth) {
+	size_t vertices;
+	size_t indices;
+	countPrimitive(primitive, vertices, indices);
+
+	/* view of the next free range of both arenas */
+	const pje::engine::types::LSysPrimitive view = {
+		static_cast<uint32_t>(m_offsetVCount), static_cast<uint32_t>(vertices),
+		static_cast<uint32_t>(m_offsetICount), static_cast<uint32_t>(indices), depth
+	};
+
+	/* update PlantTurtle's offsets for next call of appendPrimitive() */
+	m_offsetVCount += vertices;
+	m_offsetICount += indices;
+
+	/* only without exact count (stream) => amortized growth */
+	if (m_offsetVCount > m_renderable.m_vertices.size())
+		m_renderable.m_vertices.resize(std::max(m_offsetVCount, 2 * m_renderable.m_vertices.size()));
+	if (m_offsetICount > m_renderable.m_indices.size())
+		m_renderable.m_indices.resize(std::max(m_offsetICount, 2 * m_renderable.m_indices.size()));
+
+	m_renderable.m_objectPrimitives.push_back(view);
+	return view;
+}
+
+void pje::engine::PlantTurtle::placePrimitive(pje::engine::types::PrimitiveKind kind, const glm::mat4& modelMat, const BuildCounters& counters, glm::uint boneRefOffset, glm::uint boneRefCount, uint32_t depth) {
+	if (m_buildMode == BuildMode::Instances) {
+		m_renderable.m_instances[counters.deployed] = pje::engine::types::PrimitiveInstance{
+			modelMat, m_sourceIds[static_cast<size_t>(kind)], boneRefOffset, boneRefCount, depth
+		};
+		return;
+	}
+
+	const pje::engine::types::Primitive& primitive = m_registry->at(kind);
+
+	size_t vertices;
+	size_t indices;
+	countPrimitive(primitive, vertices, indices);
 
-	/* ### R_z(degrees) := I * R_y(-90.0f) * R_x(degrees) * R_y(90.0f) ### */
+	const pje::engine::types::LSysPrimitive view = {
+		counters.vertices, static_cast<uint32_t>(vertices), counters.indices, static_cast<uint32_t>(indices), depth
+	};
+	m_renderable.m_objectPrimitives[counters.deployed] = view;
+	writePrimitive(primitive, view, modelMat, boneRefOffset, boneRefCount);
+}
+
+void pje::engine::PlantTurtle::writePrimitive(const pje::engine::types::Primitive& primitive, const pje::engine::types::LSysPrimitive& view, const glm::mat4& modelMat, glm::uint boneRefOffset, glm::uint boneRefCount) {
+	pje::engine::types::Vertex*	vertices	= m_renderable.m_vertices.data() + view.firstVertex;
+	uint32_t*					indices		= m_renderable.m_indices.data() + view.firstIndex;
+	uint32_t					baseVertex	= 0;
+
+	for (const auto& mesh : primitive.m_meshes) {
+		/* vertex to model space: O_i * v | normal matrix once per mesh | uvec2(<first relevant boneRef>, <boneRefsCount for this vertex>) */
+		pje::engine::VertexKernel::transform(
+			mesh.m_vertices.data(), vertices, mesh.m_vertices.size(), modelMat, glm::uvec2(boneRefOffset, boneRefCount)
+		);
+		/* mesh indices => relative to firstVertex of view */
+		std::transform(
+			mesh.m_indices.begin(),
+			mesh.m_indices.end(),
+			indices,
+			[baseVertex](uint32_t index) { return baseVertex + index; }
+		);
 
-	// R_z(degrees) //
-	//rotation = glm::rotate(rotation, glm::radians(degrees), glm::vec3(0.0f, 0.0f, 1.0f));
+		vertices	+= mesh.m_vertices.size();
+		indices		+= mesh.m_indices.size();
+		baseVertex	+= static_cast<uint32_t>(mesh.m_vertices.size());
+	}
+}
 
-	// I * R_y(-90.0f) * R_x(degrees) * R_y(90.0f) //
-	rotation = glm::rotate(rotation, glm::radians(-90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-	rotation = glm::rotate(rotation, glm::radians(degrees), glm::vec3(1.0f, 0.0f, 0.0f));
-	rotation = glm::rotate(rotation, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+void pje::engine::PlantTurtle::countPrimitive(const pje::engine::types::Primitive& primitive, size_t& vertices, size_t& indices) {
+	vertices	= 0;
+	indices		= 0;
+	for (const auto& mesh : primitive.m_meshes) {
+		vertices	+= mesh.m_vertices.size();
+		indices		+= mesh.m_indices.size();
+	}
+}
 
-	/* local rotation: m_turtlePosMat * rotation */
-	m_turtlePosMat *= rotation;
+void pje::engine::PlantTurtle::tiltTurtle(float degrees) {
+	/* local rotation: m_turtlePose * rotation */
+	m_turtlePose = m_turtlePose.rotated(tiltRotation(degrees));
 #ifdef DEBUG
-	std::cout << "[GLM] \tColumns of tilted m_turtlePosMat:\n\t" << glm::to_string(m_turtlePosMat) << std::endl;
+	std::cout << "[GLM] \tColumns of tilted m_turtlePose:\n\t" << glm::to_string(m_turtlePose.toMat4()) << std::endl;
 #endif // DEBUG
 }
 
+glm::quat pje::engine::PlantTurtle::tiltRotation(float degrees) {
+	/* ### R_z(degrees) == I * R_y(-90.0f) * R_x(degrees) * R_y(90.0f) ### */
+	return glm::angleAxis(glm::radians(degrees), glm::vec3(0.0f, 0.0f, 1.0f));
+}
+
 pje::engine::types::Bone pje::engine::PlantTurtle::createBone() {
-	/* Bone(restpose, restposeInv, animationpose) */
+	/* bone of the current branch => parent | new bone is appended next => latest bone of the current branch */
+	const uint32_t parent = m_branchBone;
+	m_branchBone = static_cast<uint32_t>(m_renderable.m_bones.size());
+
+	return createBone(m_turtlePose, parent);
+}
+
+pje::engine::types::Bone pje::engine::PlantTurtle::createBone(const pje::engine::types::RigidTransform& turtlePose, uint32_t parent) {
+	/* Bone(restpose, animationpose, parent) | restposeInv is closed-form => RigidTransform::inverse() */
 	return pje::engine::types::Bone{
-		m_turtlePosMat, glm::inverse(m_turtlePosMat), glm::mat4(1.0f)
+		turtlePose, glm::mat4(1.0f), parent
 	};
 }
 
 pje::engine::types::BoneRef pje::engine::PlantTurtle::createRef() {
-	/* BoneRef(boneId, weight) */
+	/* BoneRef(boneId, weight) | latest bone of the current branch => primitives after ']' follow their own branch */
 	return pje::engine::types::BoneRef{
-		static_cast<uint32_t>(m_renderable.m_bones.size() - 1),
+		m_branchBone,
 		1.0f // PROJECT LIMITATION: 1 vertex <-> 1 bone
 	};
 }
\ No newline at end of file
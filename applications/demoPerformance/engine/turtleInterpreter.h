@@ -5,7 +5,6 @@
 	#include <string>							// std::string
 	#include <array>							// std::array
 	#include <vector>							// std::vector
-	#include <unordered_map>					// hashtable
 	#include <stack>							// std::stack
 	
 	#include <iostream>							// i/o stream
@@ -18,6 +17,10 @@
 
 /* Project Files */
 	#include "pjeBuffers.h"
+	#include "lSysGenerator.h"
+	#include "lSysDag.h"
+	#include "lSysParametric.h"
+	#include "vertexKernel.h"
 
 namespace pje::engine {
 
@@ -27,50 +30,176 @@ namespace pje::engine {
 	public:
 		TurtleInterpreter() = delete;
 		virtual ~TurtleInterpreter() {};
-		virtual void buildLSysObject(std::string lSysWord, const std::vector<Source>& source) = 0;
+		virtual void buildLSysObject(const std::string& lSysWord, const Source& source) = 0;
+		virtual void buildLSysObject(const pje::engine::PackedWord& lSysWord, const Source& source) = 0;
+		virtual void buildLSysObject(pje::engine::LSysStream& lSysStream, const Source& source) = 0;
+		virtual void buildLSysObject(const pje::engine::LSysDag& lSysDag, const Source& source) = 0;
+		virtual void buildLSysObject(const pje::engine::LSysParametricWord& lSysWord, const Source& source) = 0;
 
 	protected:
 		const std::string		m_alphabet;
-		glm::mat4				m_turtlePosMat;		// build helper: current position of turtle
-		std::stack<glm::mat4>	m_restposes;		// build helper: snapshots of m_turtlePosMat
+		pje::engine::types::RigidTransform				m_turtlePose;	// build helper: current position of turtle
+		std::stack<pje::engine::types::RigidTransform>	m_restposes;	// build helper: snapshots of m_turtlePose
 
-		TurtleInterpreter(std::string validAlphabet) : m_alphabet(validAlphabet), m_turtlePosMat(glm::mat4(1.0f)), m_restposes() {};
+		TurtleInterpreter(std::string validAlphabet) : m_alphabet(validAlphabet), m_turtlePose(), m_restposes() {};
 	};
 
 	/* PlantTurtle - Generates animatable 3D object */
-	class PlantTurtle final : public TurtleInterpreter<pje::engine::types::Primitive> {
+	class PlantTurtle final : public TurtleInterpreter<pje::engine::types::PrimitiveRegistry> {
 	public:
 		pje::engine::types::LSysObject m_renderable;	// latest renderable generated by buildLSysObject()
 
+		/* BuildMode
+		*	- Copies	: every deployed primitive is a transformed copy of its meshes and texture => O(symbols * mesh size)
+		*	- Instances	: every source primitive is stored once, deployed primitives are PrimitiveInstance records => O(symbols)
+		*/
+		enum class BuildMode { Copies, Instances };
+
+		/* Interpretation
+		*	- Sequential		: symbol by symbol with a stack of turtle matrices
+		*	- BranchParallel	: PackedWord is split at its brackets into segments => segments are built concurrently
+		*		>> [INFO]	offsets, bones and boneRefs are numbered exactly like Sequential
+		*		>> [INFO]	other word types are still built sequentially
+		*/
+		enum class Interpretation { Sequential, BranchParallel };
+
+		/* BuildPrediction - exact size of m_renderable before it is built */
+		struct BuildPrediction {
+			uint64_t	primitives;
+			uint64_t	instances;
+			uint64_t	bones;
+			uint64_t	boneRefs;
+			uint64_t	vertices;
+			uint64_t	indices;
+			uint64_t	bytes;			// heap and object memory of m_renderable
+		};
+
 		PlantTurtle() = delete;
 		/* STANDARD CONSTRUCTOR
 		*	> inputAlphabet	 : { S, L, F, -, +, [, ] }
 		*		> S => stem | L => leaf | F => flower | - => left tilt | + => right tilt
-		*		> [ => push m_turtlePosMat on stack | ] => pop m_turtlePosMat from stack
+		*		> [ => push m_turtlePose on stack | ] => pop m_turtlePose from stack
+		*	> parametric modules	 : S(length) | L(scale) | F(scale) | -(degrees) | +(degrees)
 		*/
 		PlantTurtle(std::string inputAlphabet);
 		~PlantTurtle();
 
-		/* builds LSysObject by evaluating a given lSysWord and using a given set of Primitives */
-		void buildLSysObject(std::string lSysWord, const std::vector<pje::engine::types::Primitive>& primitives) override;
+		/* mode of upcoming calls of buildLSysObject() */
+		void setBuildMode(BuildMode mode);
+		BuildMode getBuildMode() const;
+		/* interpretation of upcoming calls of buildLSysObject() */
+		void setInterpretation(Interpretation interpretation);
+		Interpretation getInterpretation() const;
+
+		/* predicts m_renderable for a predicted word => S, L, F := primitive with BoneRef | -, + := bone */
+		BuildPrediction predictLSysObject(const pje::engine::LSysGenerator::WordPrediction& word, const pje::engine::types::PrimitiveRegistry& primitives) const;
+		/* upcoming buildLSysObject(LSysStream&) sizes all containers of m_renderable once via prediction
+		*	>> [INFO]	every other word is counted by a first pass => containers and arenas are always sized exactly
+		*/
+		void reserveLSysObject(const BuildPrediction& prediction);
+
+		/* builds LSysObject by evaluating a given lSysWord and using the Primitives of a given registry */
+		void buildLSysObject(const std::string& lSysWord, const pje::engine::types::PrimitiveRegistry& primitives) override;
+		/* builds LSysObject by evaluating a packed lSysWord symbol by symbol => word is never unpacked */
+		void buildLSysObject(const pje::engine::PackedWord& lSysWord, const pje::engine::types::PrimitiveRegistry& primitives) override;
+		/* builds LSysObject while lSysStream derives its symbols depth-first (fused) => word is never stored | memory: O(iterations) + m_renderable */
+		void buildLSysObject(pje::engine::LSysStream& lSysStream, const pje::engine::types::PrimitiveRegistry& primitives) override;
+		/* builds LSysObject by walking the shared nodes of lSysDag => word is never flattened */
+		void buildLSysObject(const pje::engine::LSysDag& lSysDag, const pje::engine::types::PrimitiveRegistry& primitives) override;
+		/* builds LSysObject by evaluating parametric modules => S(length) replaces stacked stems */
+		void buildLSysObject(const pje::engine::LSysParametricWord& lSysWord, const pje::engine::types::PrimitiveRegistry& primitives) override;
+		/* builds LSysObject of lSysWord by reusing m_renderable of the prior call (e.g. --c= stepped from N to N+1)
+		*	>> [INFO]	words are diffed by branch => geometry, bones and boneRefs of all branches before the first changed branch are kept
+		*	>> [INFO]	changed and appended branches are evaluated again => returned patch lists the rewritten ranges for the renderers
+		*	>> [INFO]	first call, other primitives or BuildMode::Instances (instances are grouped by source) => full build
+		*/
+		pje::engine::types::LSysObjectPatch rebuildLSysObject(const pje::engine::PackedWord& lSysWord, const pje::engine::types::PrimitiveRegistry& primitives);
+		/* derives levels LSysLods of the latest build => LOD i prunes branches nested deeper than maxDepth * (levels - 1 - i) / (levels - 1)
+		*	>> [INFO]	every LSysLod shares vertices, indices, bones and boneRefs of m_renderable => only its draw lists are stored
+		*	>> [INFO]	also sets m_renderable.m_bounds for the LOD selection of the renderers
+		*/
+		void buildLodChain(uint32_t levels);
 
 	private:
+		/* BuildCounters - sizes of m_renderable right before a symbol is evaluated */
+		struct BuildCounters {
+			uint32_t	deployed;		// deployed primitives (instanced: PrimitiveInstances)
+			uint32_t	boneRefs;
+			uint32_t	bones;
+			uint32_t	vertices;		// => m_offsetPriorPrimitivesVertices
+			uint32_t	indices;		// => m_offsetPriorPrimitivesIndices
+		};
+
+		/* BranchSegment - bracket free symbols [begin, end) of one branch */
+		struct BranchSegment {
+			size_t			begin;
+			size_t			end;
+			uint32_t		branch;
+			int32_t			childBranch;	// branch opened by '[' at end | -1 => segment ends at ']' or word end
+			uint32_t		bone;			// bone of the branch at begin => BoneRef of its primitives and parent of its next bone
+			BuildCounters	counters;		// at begin
+		};
+
 		size_t m_offsetVCount = 0;		// build helper: set via LSysPrimitive::m_offsetPriorPrimitivesVertices
 		size_t m_offsetICount = 0;		// build helper: set via LSysPrimitive::m_offsetPriorPrimitivesIndices
+		const pje::engine::types::PrimitiveRegistry* m_registry = nullptr;						// build helper: set via beginLSysObject()
+		BuildPrediction m_reservation = {};															// build helper: set via reserveLSysObject()
+		BuildMode m_buildMode = BuildMode::Copies;
+		std::array<uint32_t, pje::engine::types::PrimitiveRegistry::kindCount> m_sourceIds = {};	// build helper: PrimitiveKind => primitiveId of PrimitiveInstance
+		Interpretation m_interpretation = Interpretation::Sequential;
+		pje::engine::PackedWord m_priorWord;														// build helper: word of the latest rebuildLSysObject()
+		bool m_priorValid = false;																	// build helper: m_renderable was built from m_priorWord
+		std::vector<uint32_t> m_openNodes;															// build helper: open nodes of m_renderable.m_branchNodes
+		uint32_t m_branchBone = pje::engine::types::Bone::root;										// build helper: latest bone of the current branch
+		std::stack<uint32_t> m_branchBones;															// build helper: snapshots of m_branchBone (next to m_restposes)
+
+		/* first pass: occurrences of every command inside of lSysWord */
+		static pje::engine::LSysGenerator::WordPrediction countCommands(const std::string& lSysWord);
+		static pje::engine::LSysGenerator::WordPrediction countCommands(const pje::engine::PackedWord& lSysWord);
+		static pje::engine::LSysGenerator::WordPrediction countCommands(const pje::engine::LSysDag& lSysDag);
+		static pje::engine::LSysGenerator::WordPrediction countCommands(const pje::engine::LSysParametricWord& lSysWord);
+		/* resets build helpers and m_renderable, sizes its containers and arenas via sizes, deploys first bone and ground primitive */
+		void beginLSysObject(const pje::engine::types::PrimitiveRegistry& primitives, const BuildPrediction& sizes);
+		/* prints summary of m_renderable */
+		void endLSysObject();
+		/* restores m_turtlePose, m_restposes, m_branchBone and m_branchBones after the symbols [0, end) of lSysWord without deploying anything => sizes of m_renderable at end */
+		BuildCounters replayLSysObject(const pje::engine::PackedWord& lSysWord, size_t end);
+
+		/* '[' => opens a node of the branch BVH at the next deployed primitive | ']' => closes it after the latest one */
+		void openBranchNode(uint32_t deployed);
+		void closeBranchNode(uint32_t deployed);
+		/* deployed primitives so far (instanced: PrimitiveInstances) */
+		uint32_t countDeployed() const;
+		/* AABB, wind lever and wind chain of every node of m_renderable.m_branchNodes | instanced: m_instanceBounds before the instances are grouped */
+		void boundBranchNodes();
+
+		/* BranchParallel: counts segments sequentially, resolves their turtle matrices level by level and deploys them concurrently */
+		void buildBranchParallel(const pje::engine::PackedWord& lSysWord);
 
-		/* procedural generation of m_renderable */
-		void evaluateLSysCommand(const char& command, const std::unordered_map<std::string, pje::engine::types::Primitive>& primitiveSet);
-		/* deploys primitive by solving multiple tasks:
-		*	1) deploys primitive via m_turtlePosMat			=> m_renderable
+		/* procedural generation of m_renderable | params[0] overrides default length, scale or degrees of command */
+		void evaluateLSysCommand(const char& command, const float* params = nullptr, uint8_t paramCount = 0);
+		/* deploys primitive of kind by solving multiple tasks:
+		*	1) deploys primitive via m_turtlePose * scale	=> m_renderable (BuildMode::Instances => PrimitiveInstance)
 		*	2) assigns (old/new) boneMatrix && new boneRef	=> m_renderable
-		*	3) moves m_turtlePosMat by postTurtleTranslation
+		*	3) moves m_turtlePose by postTurtleTranslation
 		*/
-		void deployPrimitive(const pje::engine::types::Primitive& primitive, const glm::vec3& postTurtleTranslation, bool needsBoneRef);
-		/* rotates m_turtlePosMat by given rotationMat */
+		void deployPrimitive(pje::engine::types::PrimitiveKind kind, const glm::vec3& postTurtleTranslation, bool needsBoneRef, const glm::vec3& scale = glm::vec3(1.0f));
+		/* appends a view of primitive to m_renderable.m_objectPrimitives and advances the vertex/index offsets | arenas only grow without prior count */
+		pje::engine::types::LSysPrimitive appendPrimitive(const pje::engine::types::Primitive& primitive, uint32_t depth);
+		/* writes primitive of kind placed by modelMat into deployed slot of m_renderable (BuildMode::Instances => PrimitiveInstance) */
+		void placePrimitive(pje::engine::types::PrimitiveKind kind, const glm::mat4& modelMat, const BuildCounters& counters, glm::uint boneRefOffset, glm::uint boneRefCount, uint32_t depth);
+		/* writes meshes of primitive into the arenas at view | vertex: primitive space => model space | index: mesh => view */
+		void writePrimitive(const pje::engine::types::Primitive& primitive, const pje::engine::types::LSysPrimitive& view, const glm::mat4& modelMat, glm::uint boneRefOffset, glm::uint boneRefCount);
+		/* vertices and indices that primitive adds to the arenas */
+		static void countPrimitive(const pje::engine::types::Primitive& primitive, size_t& vertices, size_t& indices);
+		/* rotates m_turtlePose by R_z(degrees) */
 		void tiltTurtle(float degrees);
-		/* creates a new Bone object for m_renderable.m_boneMatrices */
+		/* R_z(degrees) of tiltTurtle() */
+		static glm::quat tiltRotation(float degrees);
+		/* creates a new Bone object for m_renderable.m_bones | child of m_branchBone => becomes m_branchBone */
 		pje::engine::types::Bone createBone();
-		/* creates a new BoneRef object for m_renderable.m_boneRefs */
+		static pje::engine::types::Bone createBone(const pje::engine::types::RigidTransform& turtlePose, uint32_t parent);
+		/* creates a new BoneRef object for m_renderable.m_boneRefs => m_branchBone */
 		pje::engine::types::BoneRef createRef();
 	};
 }
\ No newline at end of file
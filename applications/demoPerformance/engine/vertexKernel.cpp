@@ -0,0 +1,254 @@
+#include "vertexKernel.h"
+
+/* intrinsics and CPUID are x86 specific => kept out of vertexKernel.h */
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define PJE_VERTEX_KERNEL_X86
+	#include <immintrin.h>
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+		#define PJE_TARGET_SSE
+		#define PJE_TARGET_AVX2
+	#else
+		#define PJE_TARGET_SSE	__attribute__((target("sse2")))
+		#define PJE_TARGET_AVX2	__attribute__((target("avx2,fma")))
+	#endif
+#endif
+
+#include <cmath>
+
+namespace {
+	/* Vertex as floats => SoA batches are gathered with a stride of floatsPerVertex */
+	constexpr size_t floatsPerVertex	= sizeof(pje::engine::types::Vertex) / sizeof(float);
+	constexpr size_t posOffset			= offsetof(pje::engine::types::Vertex, m_pos) / sizeof(float);
+	constexpr size_t normalOffset		= offsetof(pje::engine::types::Vertex, m_normal) / sizeof(float);
+
+	static_assert(sizeof(pje::engine::types::Vertex) % sizeof(float) == 0, "VertexKernel expects a Vertex made of 4 byte components.");
+}
+
+pje::engine::VertexKernel::Isa pje::engine::VertexKernel::getIsa() {
+	static const Isa isa = detectIsa();
+	return isa;
+}
+
+bool pje::engine::VertexKernel::supports(Isa isa) {
+	return isa <= getIsa();
+}
+
+const char* pje::engine::VertexKernel::nameOf(Isa isa) {
+	switch (isa) {
+	case Isa::SSE:	return "SSE";
+	case Isa::AVX2:	return "AVX2";
+	default:		return "Scalar";
+	}
+}
+
+pje::engine::VertexKernel::Isa pje::engine::VertexKernel::detectIsa() {
+#if defined(PJE_VERTEX_KERNEL_X86)
+	#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	const int maxLeaf = info[0];
+
+	__cpuid(info, 1);
+	const bool sse2		= (info[3] & (1 << 26)) != 0;
+	const bool fma		= (info[2] & (1 << 12)) != 0;
+	/* AVX registers must also be saved by the OS */
+	const bool ymm		= (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+	bool avx2			= false;
+	if (maxLeaf >= 7) {
+		__cpuidex(info, 7, 0);
+		avx2 = (info[1] & (1 << 5)) != 0;
+	}
+	#else
+	__builtin_cpu_init();
+	const bool sse2		= __builtin_cpu_supports("sse2");
+	const bool fma		= __builtin_cpu_supports("fma");
+	const bool ymm		= __builtin_cpu_supports("avx");
+	const bool avx2		= __builtin_cpu_supports("avx2");
+	#endif
+
+	if (avx2 && fma && ymm)
+		return Isa::AVX2;
+	if (sse2)
+		return Isa::SSE;
+#endif
+	return Isa::Scalar;
+}
+
+void pje::engine::VertexKernel::transform(
+	const pje::engine::types::Vertex*	src,
+	pje::engine::types::Vertex*			dst,
+	size_t								count,
+	const glm::mat4&					modelMat,
+	const glm::uvec2&					boneAttrib,
+	Isa									isa
+) {
+	/* normal matrix once per call | w of a transformed normal is dropped before normalizing */
+	const glm::mat3 normalMat = glm::transpose(glm::inverse(glm::mat3(modelMat)));
+
+	KernelMatrices matrices;
+	for (int row = 0; row < 3; row++) {
+		for (int column = 0; column < 4; column++)
+			matrices.model[row][column] = modelMat[column][row];
+		for (int column = 0; column < 3; column++)
+			matrices.normal[row][column] = normalMat[column][row];
+	}
+
+	if (!supports(isa))
+		isa = getIsa();
+
+	switch (isa) {
+	case Isa::AVX2:
+		transformAVX2(src, dst, count, matrices, boneAttrib);
+		break;
+	case Isa::SSE:
+		transformSSE(src, dst, count, matrices, boneAttrib);
+		break;
+	default:
+		transformScalar(src, dst, count, matrices, boneAttrib);
+	}
+}
+
+void pje::engine::VertexKernel::transformScalar(const pje::engine::types::Vertex* src, pje::engine::types::Vertex* dst, size_t count, const KernelMatrices& matrices, const glm::uvec2& boneAttrib) {
+	const auto& m = matrices.model;
+	const auto& n = matrices.normal;
+
+	for (size_t i = 0; i < count; i++) {
+		const pje::engine::types::Vertex& v = src[i];
+
+		const float nx		= n[0][0] * v.m_normal.x + n[0][1] * v.m_normal.y + n[0][2] * v.m_normal.z;
+		const float ny		= n[1][0] * v.m_normal.x + n[1][1] * v.m_normal.y + n[1][2] * v.m_normal.z;
+		const float nz		= n[2][0] * v.m_normal.x + n[2][1] * v.m_normal.y + n[2][2] * v.m_normal.z;
+		const float invLen	= 1.0f / std::sqrt(nx * nx + ny * ny + nz * nz);
+
+		dst[i] = pje::engine::types::Vertex(
+			glm::vec3(
+				m[0][0] * v.m_pos.x + m[0][1] * v.m_pos.y + m[0][2] * v.m_pos.z + m[0][3],
+				m[1][0] * v.m_pos.x + m[1][1] * v.m_pos.y + m[1][2] * v.m_pos.z + m[1][3],
+				m[2][0] * v.m_pos.x + m[2][1] * v.m_pos.y + m[2][2] * v.m_pos.z + m[2][3]
+			),
+			glm::vec3(nx * invLen, ny * invLen, nz * invLen),
+			v.m_uv,
+			boneAttrib
+		);
+	}
+}
+
+#if defined(PJE_VERTEX_KERNEL_X86)
+
+PJE_TARGET_SSE void pje::engine::VertexKernel::transformSSE(const pje::engine::types::Vertex* src, pje::engine::types::Vertex* dst, size_t count, const KernelMatrices& matrices, const glm::uvec2& boneAttrib) {
+	const auto& m = matrices.model;
+	const auto& n = matrices.normal;
+
+	const __m128 m00 = _mm_set1_ps(m[0][0]), m01 = _mm_set1_ps(m[0][1]), m02 = _mm_set1_ps(m[0][2]), m03 = _mm_set1_ps(m[0][3]);
+	const __m128 m10 = _mm_set1_ps(m[1][0]), m11 = _mm_set1_ps(m[1][1]), m12 = _mm_set1_ps(m[1][2]), m13 = _mm_set1_ps(m[1][3]);
+	const __m128 m20 = _mm_set1_ps(m[2][0]), m21 = _mm_set1_ps(m[2][1]), m22 = _mm_set1_ps(m[2][2]), m23 = _mm_set1_ps(m[2][3]);
+	const __m128 n00 = _mm_set1_ps(n[0][0]), n01 = _mm_set1_ps(n[0][1]), n02 = _mm_set1_ps(n[0][2]);
+	const __m128 n10 = _mm_set1_ps(n[1][0]), n11 = _mm_set1_ps(n[1][1]), n12 = _mm_set1_ps(n[1][2]);
+	const __m128 n20 = _mm_set1_ps(n[2][0]), n21 = _mm_set1_ps(n[2][1]), n22 = _mm_set1_ps(n[2][2]);
+	const __m128 one = _mm_set1_ps(1.0f);
+
+	alignas(16) float out[6][4];
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4) {
+		/* AoS => SoA */
+		const float* b = reinterpret_cast<const float*>(src + i);
+		const size_t s = floatsPerVertex;
+		const __m128 px = _mm_setr_ps(b[posOffset],			b[s + posOffset],			b[2 * s + posOffset],			b[3 * s + posOffset]);
+		const __m128 py = _mm_setr_ps(b[posOffset + 1],		b[s + posOffset + 1],		b[2 * s + posOffset + 1],		b[3 * s + posOffset + 1]);
+		const __m128 pz = _mm_setr_ps(b[posOffset + 2],		b[s + posOffset + 2],		b[2 * s + posOffset + 2],		b[3 * s + posOffset + 2]);
+		const __m128 vx = _mm_setr_ps(b[normalOffset],		b[s + normalOffset],		b[2 * s + normalOffset],		b[3 * s + normalOffset]);
+		const __m128 vy = _mm_setr_ps(b[normalOffset + 1],	b[s + normalOffset + 1],	b[2 * s + normalOffset + 1],	b[3 * s + normalOffset + 1]);
+		const __m128 vz = _mm_setr_ps(b[normalOffset + 2],	b[s + normalOffset + 2],	b[2 * s + normalOffset + 2],	b[3 * s + normalOffset + 2]);
+
+		/* M * (p, 1) */
+		_mm_store_ps(out[0], _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, px), _mm_mul_ps(m01, py)), _mm_add_ps(_mm_mul_ps(m02, pz), m03)));
+		_mm_store_ps(out[1], _mm_add_ps(_mm_add_ps(_mm_mul_ps(m10, px), _mm_mul_ps(m11, py)), _mm_add_ps(_mm_mul_ps(m12, pz), m13)));
+		_mm_store_ps(out[2], _mm_add_ps(_mm_add_ps(_mm_mul_ps(m20, px), _mm_mul_ps(m21, py)), _mm_add_ps(_mm_mul_ps(m22, pz), m23)));
+
+		/* normalize(N * n) */
+		const __m128 nx		= _mm_add_ps(_mm_add_ps(_mm_mul_ps(n00, vx), _mm_mul_ps(n01, vy)), _mm_mul_ps(n02, vz));
+		const __m128 ny		= _mm_add_ps(_mm_add_ps(_mm_mul_ps(n10, vx), _mm_mul_ps(n11, vy)), _mm_mul_ps(n12, vz));
+		const __m128 nz		= _mm_add_ps(_mm_add_ps(_mm_mul_ps(n20, vx), _mm_mul_ps(n21, vy)), _mm_mul_ps(n22, vz));
+		const __m128 invLen	= _mm_div_ps(one, _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)), _mm_mul_ps(nz, nz))));
+		_mm_store_ps(out[3], _mm_mul_ps(nx, invLen));
+		_mm_store_ps(out[4], _mm_mul_ps(ny, invLen));
+		_mm_store_ps(out[5], _mm_mul_ps(nz, invLen));
+
+		/* SoA => AoS */
+		for (size_t k = 0; k < 4; k++) {
+			dst[i + k] = pje::engine::types::Vertex(
+				glm::vec3(out[0][k], out[1][k], out[2][k]), glm::vec3(out[3][k], out[4][k], out[5][k]), src[i + k].m_uv, boneAttrib
+			);
+		}
+	}
+
+	transformScalar(src + i, dst + i, count - i, matrices, boneAttrib);
+}
+
+PJE_TARGET_AVX2 void pje::engine::VertexKernel::transformAVX2(const pje::engine::types::Vertex* src, pje::engine::types::Vertex* dst, size_t count, const KernelMatrices& matrices, const glm::uvec2& boneAttrib) {
+	const auto& m = matrices.model;
+	const auto& n = matrices.normal;
+
+	const __m256 m00 = _mm256_set1_ps(m[0][0]), m01 = _mm256_set1_ps(m[0][1]), m02 = _mm256_set1_ps(m[0][2]), m03 = _mm256_set1_ps(m[0][3]);
+	const __m256 m10 = _mm256_set1_ps(m[1][0]), m11 = _mm256_set1_ps(m[1][1]), m12 = _mm256_set1_ps(m[1][2]), m13 = _mm256_set1_ps(m[1][3]);
+	const __m256 m20 = _mm256_set1_ps(m[2][0]), m21 = _mm256_set1_ps(m[2][1]), m22 = _mm256_set1_ps(m[2][2]), m23 = _mm256_set1_ps(m[2][3]);
+	const __m256 n00 = _mm256_set1_ps(n[0][0]), n01 = _mm256_set1_ps(n[0][1]), n02 = _mm256_set1_ps(n[0][2]);
+	const __m256 n10 = _mm256_set1_ps(n[1][0]), n11 = _mm256_set1_ps(n[1][1]), n12 = _mm256_set1_ps(n[1][2]);
+	const __m256 n20 = _mm256_set1_ps(n[2][0]), n21 = _mm256_set1_ps(n[2][1]), n22 = _mm256_set1_ps(n[2][2]);
+	const __m256 one = _mm256_set1_ps(1.0f);
+
+	/* float index of each of the 8 vertices of a batch */
+	const __m256i stride = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(static_cast<int>(floatsPerVertex)));
+
+	alignas(32) float out[6][8];
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8) {
+		/* AoS => SoA */
+		const float* b = reinterpret_cast<const float*>(src + i);
+		const __m256 px = _mm256_i32gather_ps(b + posOffset,			stride, sizeof(float));
+		const __m256 py = _mm256_i32gather_ps(b + posOffset + 1,		stride, sizeof(float));
+		const __m256 pz = _mm256_i32gather_ps(b + posOffset + 2,		stride, sizeof(float));
+		const __m256 vx = _mm256_i32gather_ps(b + normalOffset,		stride, sizeof(float));
+		const __m256 vy = _mm256_i32gather_ps(b + normalOffset + 1,	stride, sizeof(float));
+		const __m256 vz = _mm256_i32gather_ps(b + normalOffset + 2,	stride, sizeof(float));
+
+		/* M * (p, 1) */
+		_mm256_store_ps(out[0], _mm256_fmadd_ps(m00, px, _mm256_fmadd_ps(m01, py, _mm256_fmadd_ps(m02, pz, m03))));
+		_mm256_store_ps(out[1], _mm256_fmadd_ps(m10, px, _mm256_fmadd_ps(m11, py, _mm256_fmadd_ps(m12, pz, m13))));
+		_mm256_store_ps(out[2], _mm256_fmadd_ps(m20, px, _mm256_fmadd_ps(m21, py, _mm256_fmadd_ps(m22, pz, m23))));
+
+		/* normalize(N * n) */
+		const __m256 nx		= _mm256_fmadd_ps(n00, vx, _mm256_fmadd_ps(n01, vy, _mm256_mul_ps(n02, vz)));
+		const __m256 ny		= _mm256_fmadd_ps(n10, vx, _mm256_fmadd_ps(n11, vy, _mm256_mul_ps(n12, vz)));
+		const __m256 nz		= _mm256_fmadd_ps(n20, vx, _mm256_fmadd_ps(n21, vy, _mm256_mul_ps(n22, vz)));
+		const __m256 invLen	= _mm256_div_ps(one, _mm256_sqrt_ps(_mm256_fmadd_ps(nx, nx, _mm256_fmadd_ps(ny, ny, _mm256_mul_ps(nz, nz)))));
+		_mm256_store_ps(out[3], _mm256_mul_ps(nx, invLen));
+		_mm256_store_ps(out[4], _mm256_mul_ps(ny, invLen));
+		_mm256_store_ps(out[5], _mm256_mul_ps(nz, invLen));
+
+		/* SoA => AoS */
+		for (size_t k = 0; k < 8; k++) {
+			dst[i + k] = pje::engine::types::Vertex(
+				glm::vec3(out[0][k], out[1][k], out[2][k]), glm::vec3(out[3][k], out[4][k], out[5][k]), src[i + k].m_uv, boneAttrib
+			);
+		}
+	}
+
+	transformScalar(src + i, dst + i, count - i, matrices, boneAttrib);
+}
+
+#else
+
+/* no x86 => scalar only */
+void pje::engine::VertexKernel::transformSSE(const pje::engine::types::Vertex* src, pje::engine::types::Vertex* dst, size_t count, const KernelMatrices& matrices, const glm::uvec2& boneAttrib) {
+	transformScalar(src, dst, count, matrices, boneAttrib);
+}
+
+void pje::engine::VertexKernel::transformAVX2(const pje::engine::types::Vertex* src, pje::engine::types::Vertex* dst, size_t count, const KernelMatrices& matrices, const glm::uvec2& boneAttrib) {
+	transformScalar(src, dst, count, matrices, boneAttrib);
+}
+
+#endif
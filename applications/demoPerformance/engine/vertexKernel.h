@@ -0,0 +1,54 @@
+/* Ignores header if not needed after #include */
+	#pragma once
+
+/* Third Party Files */
+	#include <cstdint>							// fixed size integer
+	#include <cstddef>							// size_t
+
+	#include <glm/glm.hpp>						// glm types
+
+/* Project Files */
+	#include "pjeBuffers.h"
+
+namespace pje::engine {
+
+	/* VertexKernel - Transforms positions and normals of vertex batches by 1 model matrix
+	*	>> [INFO]	normal matrix := transpose(inverse(mat3(modelMat))) is computed once per call instead of once per vertex
+	*	>> [INFO]	batches of 4 (SSE) or 8 (AVX2) vertices are transposed into SoA registers => tail is transformed scalar
+	*	>> [INFO]	instruction set is chosen at runtime via CPUID => Scalar on other architectures
+	*/
+	class VertexKernel {
+	public:
+		enum class Isa { Scalar, SSE, AVX2 };
+
+		VertexKernel() = delete;
+
+		/* best instruction set of this CPU (detected once) */
+		static Isa getIsa();
+		static bool supports(Isa isa);
+		static const char* nameOf(Isa isa);
+
+		/* dst[i] := Vertex(modelMat * src[i].pos, normalize(normalMat * src[i].normal), src[i].uv, boneAttrib) | src == dst is allowed */
+		static void transform(
+			const pje::engine::types::Vertex*	src,
+			pje::engine::types::Vertex*			dst,
+			size_t								count,
+			const glm::mat4&					modelMat,
+			const glm::uvec2&					boneAttrib,
+			Isa									isa = getIsa()
+		);
+
+	private:
+		/* KernelMatrices - modelMat (3x4) and normal matrix (3x3) as row-major floats for broadcasts */
+		struct KernelMatrices {
+			float model[3][4];
+			float normal[3][3];
+		};
+
+		static Isa detectIsa();
+
+		static void transformScalar(const pje::engine::types::Vertex* src, pje::engine::types::Vertex* dst, size_t count, const KernelMatrices& matrices, const glm::uvec2& boneAttrib);
+		static void transformSSE(const pje::engine::types::Vertex* src, pje::engine::types::Vertex* dst, size_t count, const KernelMatrices& matrices, const glm::uvec2& boneAttrib);
+		static void transformAVX2(const pje::engine::types::Vertex* src, pje::engine::types::Vertex* dst, size_t count, const KernelMatrices& matrices, const glm::uvec2& boneAttrib);
+	};
+}
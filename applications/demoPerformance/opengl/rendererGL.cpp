@@ -5,7 +5,9 @@
 
 pje::renderer::RendererGL::RendererGL(const pje::engine::ArgsParser& parser, GLFWwindow* const window, const pje::engine::types::LSysObject& renderable) :
 	m_handles(), m_renderWidth(parser.m_width), m_renderHeight(parser.m_height), m_windowIconified(false), 
-	m_vsync(parser.m_vsync), m_anisotropyLevel(AnisotropyLevel::TWOx), m_msaaFactor(4), m_instanceCount(parser.m_amountOfObjects) {
+	m_vsync(parser.m_vsync), m_anisotropyLevel(AnisotropyLevel::TWOx), m_msaaFactor(4), m_instanceCount(parser.m_amountOfObjects), 
+	m_instanced(renderable.isInstanced()), m_instanceRangeLocation(-1), m_buffVisibleInstances(0), m_firstObjectLocation(-1), 
+	m_compact(renderable.isCompact()), m_decodeLocations({ -1, -1, -1, -1 }), m_cullStats() {
 
 	/* Gaining access to OpenGL core functions inside of C++ */
 	glfwMakeContextCurrent(window);
@@ -23,10 +25,26 @@ pje::renderer::RendererGL::RendererGL(const pje::engine::ArgsParser& parser, GLF
 
 	/* Defining general info for renderloop */
 	setGlobalSettings();
-	/* Creating shader program */
-	setShaderProgram("basic_opengl", m_handles.shaderProgram);
+	/* Creating shader program => instanced LSysObject places its source primitives per instance */
+	setShaderProgram(m_instanced ? "instanced_opengl" : "basic_opengl", "basic_opengl", m_handles.shaderProgram);
 	/* Using shader program */
 	glUseProgram(m_handles.shaderProgram);
+
+	if (m_instanced)
+		m_instanceRangeLocation = glGetUniformLocation(m_handles.shaderProgram, "instanceRange");
+	m_firstObjectLocation = glGetUniformLocation(m_handles.shaderProgram, "firstObject");
+
+	m_decodeLocations[0] = glGetUniformLocation(m_handles.shaderProgram, "decode.positionMin");
+	m_decodeLocations[1] = glGetUniformLocation(m_handles.shaderProgram, "decode.boneRefBase");
+	m_decodeLocations[2] = glGetUniformLocation(m_handles.shaderProgram, "decode.positionExtent");
+	m_decodeLocations[3] = glGetUniformLocation(m_handles.shaderProgram, "decode.compact");
+
+	/* Vertex => decode is never touched again */
+	if (!m_compact)
+		setVertexDecode(pje::engine::types::VertexDecode{});
+
+	/* layout of 1 bone inside of StorageBones => fixed for the lifetime of this renderer */
+	glUniform1ui(glGetUniformLocation(m_handles.shaderProgram, "boneFormat"), static_cast<uint32_t>(renderable.getBoneFormat()));
 }
 
 pje::renderer::RendererGL::~RendererGL() {
@@ -34,6 +52,8 @@ pje::renderer::RendererGL::~RendererGL() {
 	glDeleteBuffers(1, &m_buffUniformMVP);
 	glDeleteBuffers(1, &m_buffStorageBoneRefs);
 	glDeleteBuffers(1, &m_buffStorageBones);
+	glDeleteBuffers(1, &m_buffStorageInstances);
+	glDeleteBuffers(1, &m_buffVisibleInstances);
 	glDeleteProgram(m_handles.shaderProgram);
 }
 
@@ -49,66 +69,62 @@ void pje::renderer::RendererGL::uploadRenderable(const pje::engine::types::LSysO
 	std::cout << "[GL3W] \tsizeof(Vertex): " << sizeof(pje::engine::types::Vertex) << std::endl;
 #endif // DEBUG
 
-	/* 1) Vertices */
-	m_handles.buffRenderable.verticesSize = static_cast<signed long long>(
-		(
-			renderable.m_objectPrimitives.back().m_meshes.back().m_vertices.size() +
-			renderable.m_objectPrimitives.back().m_meshes.back().m_offsetPriorMeshesVertices +
-			renderable.m_objectPrimitives.back().m_offsetPriorPrimitivesVertices
-		) * sizeof(pje::engine::types::Vertex)
-	);
+	/* 1) Vertices => whole arena with 1 copy | CompactVertex if quantized */
+	m_handles.buffRenderable.verticesSize = m_compact ?
+		static_cast<signed long long>(renderable.m_compactVertices.size() * sizeof(pje::engine::types::CompactVertex)) :
+		static_cast<signed long long>(renderable.m_vertices.size() * sizeof(pje::engine::types::Vertex));
 	glBindBuffer(GL_ARRAY_BUFFER, m_handles.buffRenderable.verticesHandle);
-	glBufferData(GL_ARRAY_BUFFER, m_handles.buffRenderable.verticesSize, NULL, GL_STATIC_DRAW);
-
-	/* 2) Indices */
-	m_handles.buffRenderable.indicesSize = static_cast<signed long long>(
-		(
-			renderable.m_objectPrimitives.back().m_meshes.back().m_indices.size() +
-			renderable.m_objectPrimitives.back().m_meshes.back().m_offsetPriorMeshesIndices +
-			renderable.m_objectPrimitives.back().m_offsetPriorPrimitivesIndices
-		) * sizeof(uint32_t)
+	glBufferData(
+		GL_ARRAY_BUFFER, 
+		m_handles.buffRenderable.verticesSize, 
+		m_compact ? static_cast<const void*>(renderable.m_compactVertices.data()) : static_cast<const void*>(renderable.m_vertices.data()), 
+		GL_STATIC_DRAW
 	);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_handles.buffRenderable.indicesHandle);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_handles.buffRenderable.indicesSize, NULL, GL_STATIC_DRAW);
 
-	/* 3) Uploading */
-	size_t vByteOffset = 0;
-	size_t vByteSize;
-	size_t iByteOffset = 0;
-	size_t iByteSize;
-
-	for (const auto& primitive : renderable.m_objectPrimitives) {
-		for (const auto& mesh : primitive.m_meshes) {
-			vByteSize = sizeof(pje::engine::types::Vertex) * mesh.m_vertices.size();
-			iByteSize = sizeof(uint32_t) * mesh.m_indices.size();
-
-			glBufferSubData(GL_ARRAY_BUFFER, vByteOffset, vByteSize, mesh.m_vertices.data());
-			glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, iByteOffset, iByteSize, mesh.m_indices.data());
+	/* 2) Indices => whole arena with 1 copy */
+	m_handles.buffRenderable.indicesSize = static_cast<signed long long>(renderable.m_indices.size() * sizeof(uint32_t));
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_handles.buffRenderable.indicesHandle);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_handles.buffRenderable.indicesSize, renderable.m_indices.data(), GL_STATIC_DRAW);
 
-			vByteOffset += vByteSize;
-			iByteOffset += iByteSize;
-		}
+	/* 3) Vertex Attributes of pje::::engine::types::Vertex | pje::engine::types::CompactVertex */
+	if (m_compact) {
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(
+			0, 4, GL_UNSIGNED_SHORT, true, sizeof(pje::engine::types::CompactVertex), (void*)offsetof(pje::engine::types::CompactVertex, m_pos)
+		);
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(
+			1, 2, GL_SHORT, true, sizeof(pje::engine::types::CompactVertex), (void*)offsetof(pje::engine::types::CompactVertex, m_normal)
+		);
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(
+			2, 2, GL_HALF_FLOAT, false, sizeof(pje::engine::types::CompactVertex), (void*)offsetof(pje::engine::types::CompactVertex, m_uv)
+		);
+		glEnableVertexAttribArray(3);
+		glVertexAttribIPointer(
+			3, 2, GL_UNSIGNED_SHORT, sizeof(pje::engine::types::CompactVertex), (void*)offsetof(pje::engine::types::CompactVertex, m_boneAttrib)
+		);
+	}
+	else {
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(
+			0, 3, GL_FLOAT, false, sizeof(pje::engine::types::Vertex), (void*)offsetof(pje::engine::types::Vertex, m_pos)
+		);
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(
+			1, 3, GL_FLOAT, false, sizeof(pje::engine::types::Vertex), (void*)offsetof(pje::engine::types::Vertex, m_normal)
+		);
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(
+			2, 2, GL_FLOAT, false, sizeof(pje::engine::types::Vertex), (void*)offsetof(pje::engine::types::Vertex, m_uv)
+		);
+		glEnableVertexAttribArray(3);
+		glVertexAttribIPointer(
+			3, 2, GL_UNSIGNED_INT, sizeof(pje::engine::types::Vertex), (void*)offsetof(pje::engine::types::Vertex, m_boneAttrib)
+		);
 	}
 
-	/* 4) Vertex Attributes of pje::::engine::types::Vertex */
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(
-		0, 3, GL_FLOAT, false, sizeof(pje::engine::types::Vertex), (void*)offsetof(pje::engine::types::Vertex, m_pos)
-	);
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(
-		1, 3, GL_FLOAT, false, sizeof(pje::engine::types::Vertex), (void*)offsetof(pje::engine::types::Vertex, m_normal)
-	);
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(
-		2, 2, GL_FLOAT, false, sizeof(pje::engine::types::Vertex), (void*)offsetof(pje::engine::types::Vertex, m_uv)
-	);
-	glEnableVertexAttribArray(3);
-	glVertexAttribIPointer(
-		3, 2, GL_UNSIGNED_INT, sizeof(pje::engine::types::Vertex), (void*)offsetof(pje::engine::types::Vertex, m_boneAttrib)
-	);
-
-	/* 5) Unbinding */
+	/* 4) Unbinding */
 	glBindVertexArray(0);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
@@ -208,8 +224,21 @@ void pje::renderer::RendererGL::uploadBuffer(const pje::engine::types::LSysObjec
 		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffStorageBones);
 		glBufferData(
 			GL_SHADER_STORAGE_BUFFER,
-			sizeof(glm::mat4) * renderable.m_bones.size(),
-			renderable.getBoneMatrices().data(),
+			renderable.getBoneStride() * renderable.m_bonePalette.size(),
+			renderable.getBoneData(),
+			GL_DYNAMIC_DRAW
+		);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+		break;
+	case BufferType::StorageInstances:
+		/* explicit storage buffer location/index = 2 */
+		glGenBuffers(1, &m_buffStorageInstances);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffStorageInstances);
+		glBufferData(
+			GL_SHADER_STORAGE_BUFFER,
+			sizeof(pje::engine::types::PrimitiveInstance) * renderable.m_instances.size(),
+			renderable.m_instances.data(),
 			GL_STATIC_DRAW
 		);
 		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
@@ -235,6 +264,8 @@ void pje::renderer::RendererGL::bindRenderable(const pje::engine::types::LSysObj
 	/* Storage Buffer(s) */
 	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_buffStorageBoneRefs);
 	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_buffStorageBones);
+	if (m_instanced)
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_buffStorageInstances);
 
 	/* VAO Binding */
 	glBindVertexArray(m_handles.buffRenderable.vaoHandle);
@@ -253,18 +284,59 @@ void pje::renderer::RendererGL::renderIn(GLFWwindow* window, const pje::engine::
 		if (prog != m_handles.shaderProgram) 
 			glUseProgram(m_handles.shaderProgram);
 
-		/* Drawing */
-		// Drawing each mesh of each primitive separately //
-		for (const auto& primitive : renderable.m_objectPrimitives) {
-			for (const auto& mesh : primitive.m_meshes) {
-				glDrawElementsInstancedBaseVertex(
-					GL_TRIANGLES,
-					static_cast<GLsizei>(mesh.m_indices.size()),
-					GL_UNSIGNED_INT,
-					(void*)(sizeof(uint32_t) * (primitive.m_offsetPriorPrimitivesIndices + mesh.m_offsetPriorMeshesIndices)),
-					m_instanceCount,
-					primitive.m_offsetPriorPrimitivesVertices + mesh.m_offsetPriorMeshesVertices
-				);
+		/* Drawing => objects of the same LOD share their draw calls | branches (instanced: instances) outside of the view frustum are skipped */
+		const auto runs = renderable.selectLods(m_instanceCount);
+		m_cullStats = {};
+		if (m_instanced)
+			cullInstancesOf(renderable, runs);
+
+		for (size_t r = 0; r < runs.size(); r++) {
+			const auto& run = runs[r];
+			if (!m_instanced) {
+				const auto stats = renderable.cullPrimitives(run, m_visiblePrimitives);
+				m_cullStats.visible	+= stats.visible;
+				m_cullStats.culled	+= stats.culled;
+				if (stats.visible == 0)
+					continue;
+			}
+
+			glUniform1ui(m_firstObjectLocation, run.firstObject);
+
+			if (m_instanced) {
+				// Drawing each source primitive once for all of its visible instances //
+				for (size_t id = 0; id < renderable.m_objectPrimitives.size(); id++) {
+					const auto& primitive	= renderable.m_objectPrimitives[id];
+					const auto& range		= m_visibleRanges[r * renderable.m_objectPrimitives.size() + id];
+					if (range.count == 0)
+						continue;
+
+					if (m_compact)
+						setVertexDecode(primitive.decode);
+					glUniform2ui(m_instanceRangeLocation, range.first, range.count);
+					glDrawElementsInstancedBaseVertex(
+						GL_TRIANGLES,
+						static_cast<GLsizei>(primitive.indexCount),
+						GL_UNSIGNED_INT,
+						(void*)(sizeof(uint32_t) * primitive.firstIndex),
+						static_cast<GLsizei>(range.count * run.objectCount),
+						primitive.firstVertex
+					);
+				}
+			}
+			else {
+				// Drawing each visible primitive separately => its meshes share 1 index range //
+				for (const auto& primitive : m_visiblePrimitives) {
+					if (m_compact)
+						setVertexDecode(primitive.decode);
+					glDrawElementsInstancedBaseVertex(
+						GL_TRIANGLES,
+						static_cast<GLsizei>(primitive.indexCount),
+						GL_UNSIGNED_INT,
+						(void*)(sizeof(uint32_t) * primitive.firstIndex),
+						static_cast<GLsizei>(run.objectCount),
+						primitive.firstVertex
+					);
+				}
 			}
 		}
 
@@ -301,12 +373,27 @@ void pje::renderer::RendererGL::updateBuffer(const pje::engine::types::LSysObjec
 
 		break;
 	case BufferType::StorageBones:
+		/* only dirty ranges of m_bonePalette | packed in renderable.getBoneFormat() */
+		renderable.getDirtyBoneRanges(m_dirtyBoneRanges);
 		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffStorageBones);
+		for (const auto& range : m_dirtyBoneRanges) {
+			glBufferSubData(
+				GL_SHADER_STORAGE_BUFFER,
+				renderable.getBoneStride() * range.first,
+				renderable.getBoneStride() * range.count,
+				static_cast<const char*>(renderable.getBoneData()) + renderable.getBoneStride() * range.first
+			);
+		}
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+		break;
+	case BufferType::StorageInstances:
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffStorageInstances);
 		glBufferSubData(
 			GL_SHADER_STORAGE_BUFFER,
 			0,
-			sizeof(glm::mat4) * renderable.m_bones.size(),
-			renderable.getBoneMatrices().data()
+			sizeof(pje::engine::types::PrimitiveInstance) * renderable.m_instances.size(),
+			renderable.m_instances.data()
 		);
 		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 
@@ -314,6 +401,33 @@ void pje::renderer::RendererGL::updateBuffer(const pje::engine::types::LSysObjec
 	}
 }
 
+void pje::renderer::RendererGL::updateRenderable(const pje::engine::types::LSysObject& renderable, const pje::engine::types::LSysObjectPatch& patch) {
+	/* 1) Vertices | CompactVertex if quantized (same element count) */
+	const size_t vertexStride = m_compact ? sizeof(pje::engine::types::CompactVertex) : sizeof(pje::engine::types::Vertex);
+	patchBuffer(
+		m_handles.buffRenderable.verticesHandle, GL_STATIC_DRAW, 
+		m_compact ? static_cast<const void*>(renderable.m_compactVertices.data()) : static_cast<const void*>(renderable.m_vertices.data()), 
+		vertexStride, renderable.m_vertices.size(), patch.vertices
+	);
+	m_handles.buffRenderable.verticesSize = static_cast<signed long long>(vertexStride * renderable.m_vertices.size());
+
+	/* 2) Indices */
+	patchBuffer(m_handles.buffRenderable.indicesHandle, GL_STATIC_DRAW, renderable.m_indices.data(), sizeof(uint32_t), renderable.m_indices.size(), patch.indices);
+	m_handles.buffRenderable.indicesSize = static_cast<signed long long>(sizeof(uint32_t) * renderable.m_indices.size());
+
+	/* 3) Storage buffers => handles stay bound to their binding points | contents of m_bonePalette follow via updateBuffer(StorageBones) (all entries dirty) */
+	patchBuffer(m_buffStorageBoneRefs, GL_STATIC_DRAW, renderable.m_boneRefs.data(), sizeof(pje::engine::types::BoneRef), renderable.m_boneRefs.size(), patch.boneRefs);
+	patchBuffer(m_buffStorageBones, GL_DYNAMIC_DRAW, renderable.getBoneData(), renderable.getBoneStride(), renderable.m_bonePalette.size(), pje::engine::types::ElementRange{ 0, 0 });
+	if (m_instanced)
+		patchBuffer(m_buffStorageInstances, GL_STATIC_DRAW, renderable.m_instances.data(), sizeof(pje::engine::types::PrimitiveInstance), renderable.m_instances.size(), patch.instances);
+
+	std::cout << "[GL3W] \tPatching renderable --- DONE" << std::endl;
+}
+
+pje::engine::types::CullStats pje::renderer::RendererGL::getCullStats() const {
+	return m_cullStats;
+}
+
 /* ### Private methods ### */
 
 void pje::renderer::RendererGL::setGlobalSettings() {
@@ -333,9 +447,9 @@ void pje::renderer::RendererGL::setGlobalSettings() {
 		glEnable(GL_MULTISAMPLE);
 }
 
-void pje::renderer::RendererGL::setShaderProgram(std::string shaderName, uint32_t& rawProgram) {
-	std::string vsm = loadShader("assets/shaders/" + shaderName + ".vert");
-	std::string fsm = loadShader("assets/shaders/" + shaderName + ".frag");
+void pje::renderer::RendererGL::setShaderProgram(std::string vertexShaderName, std::string fragmentShaderName, uint32_t& rawProgram) {
+	std::string vsm = loadShader("assets/shaders/" + vertexShaderName + ".vert");
+	std::string fsm = loadShader("assets/shaders/" + fragmentShaderName + ".frag");
 
 #ifdef DEBUG
 	std::cout << "\n[DEBUG - SHADERCODE]\n" << vsm << "\n\n" << fsm << std::endl;
@@ -393,4 +507,47 @@ std::string pje::renderer::RendererGL::loadShader(const std::string& filename) {
 	else {
 		throw std::runtime_error("Failed to load a shader into RAM!");
 	}
+}
+
+void pje::renderer::RendererGL::setVertexDecode(const pje::engine::types::VertexDecode& decode) {
+	glUniform3f(m_decodeLocations[0], decode.positionMin.x, decode.positionMin.y, decode.positionMin.z);
+	glUniform1ui(m_decodeLocations[1], decode.boneRefBase);
+	glUniform3f(m_decodeLocations[2], decode.positionExtent.x, decode.positionExtent.y, decode.positionExtent.z);
+	glUniform1ui(m_decodeLocations[3], decode.compact);
+}
+
+void pje::renderer::RendererGL::cullInstancesOf(const pje::engine::types::LSysObject& renderable, const std::vector<pje::engine::types::LodRun>& runs) {
+	m_visibleInstances.clear();
+	m_visibleRanges.clear();
+	for (const auto& run : runs) {
+		const auto stats = renderable.cullInstances(run, m_visibleInstances, m_visibleRanges);
+		m_cullStats.visible	+= stats.visible;
+		m_cullStats.culled	+= stats.culled;
+	}
+
+	/* explicit storage buffer location/index = 3 | orphaned every frame => no stall on the draws of the prior frame */
+	if (m_buffVisibleInstances == 0) {
+		glGenBuffers(1, &m_buffVisibleInstances);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_buffVisibleInstances);
+	}
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffVisibleInstances);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(uint32_t) * m_visibleInstances.size(), m_visibleInstances.data(), GL_STREAM_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+bool pje::renderer::RendererGL::patchBuffer(uint32_t handle, GLenum usage, const void* data, size_t stride, size_t count, const pje::engine::types::ElementRange& range) {
+	/* GL_COPY_WRITE_BUFFER => element array binding of the VAO stays untouched */
+	glBindBuffer(GL_COPY_WRITE_BUFFER, handle);
+
+	GLint64 capacity = 0;
+	glGetBufferParameteri64v(GL_COPY_WRITE_BUFFER, GL_BUFFER_SIZE, &capacity);
+
+	const bool grown = static_cast<GLint64>(stride * count) > capacity;
+	if (grown)
+		glBufferData(GL_COPY_WRITE_BUFFER, stride * count, data, usage);
+	else if (range.count > 0)
+		glBufferSubData(GL_COPY_WRITE_BUFFER, stride * range.first, stride * range.count, static_cast<const char*>(data) + stride * range.first);
+
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	return grown;
 }
\ No newline at end of file
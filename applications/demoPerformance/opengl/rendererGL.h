@@ -5,6 +5,7 @@
 	#include <cstdint>		// fixed size integer
 	#include <string>		// std::string
 	#include <vector>		// std::vector
+	#include <array>		// std::array
 	#include <limits>		// std::numeric_limits
 	#include <fstream>		// read from files
 	#include <sstream>		// parsing input (shader code)
@@ -55,12 +56,13 @@ namespace pje::renderer {
 	class RendererGL final {
 	public:
 		enum class TextureType	{ Albedo };
-		enum class BufferType	{ UniformMVP, StorageBoneRefs, StorageBones };
+		enum class BufferType	{ UniformMVP, StorageBoneRefs, StorageBones, StorageInstances };
 
 		ImageGL		m_texAlbedo;
 		uint32_t	m_buffUniformMVP;
 		uint32_t	m_buffStorageBoneRefs;
 		uint32_t	m_buffStorageBones;
+		uint32_t	m_buffStorageInstances	= 0;	// instanced LSysObject only
 
 		RendererGL() = delete;
 		RendererGL(const pje::engine::ArgsParser& parser, GLFWwindow* const window, const pje::engine::types::LSysObject& renderable);
@@ -77,6 +79,11 @@ namespace pje::renderer {
 		void renderIn(GLFWwindow* window, const pje::engine::types::LSysObject& renderable);
 		/* 4/4: Updating shader resources */
 		void updateBuffer(const pje::engine::types::LSysObject& renderable, BufferType type);
+		/* ranges of patch (PlantTurtle::rebuildLSysObject()) => glBufferSubData | buffers that became too small are allocated again */
+		void updateRenderable(const pje::engine::types::LSysObject& renderable, const pje::engine::types::LSysObjectPatch& patch);
+
+		/* frustum culling of the latest renderIn() */
+		pje::engine::types::CullStats getCullStats() const;
 
 	private:
 		enum class AnisotropyLevel { Disabled, TWOx, FOURx, EIGHTx, SIXTEENx };
@@ -89,9 +96,25 @@ namespace pje::renderer {
 		AnisotropyLevel		m_anisotropyLevel;
 		uint8_t				m_msaaFactor;
 		uint8_t				m_instanceCount;
+		bool				m_instanced;				// renderable.isInstanced() => "instanced_opengl" vertex shader
+		int					m_instanceRangeLocation;	// uniform uvec2 instanceRange of "instanced_opengl"
+		uint32_t			m_buffVisibleInstances;		// instanced: m_visibleInstances => storage buffer location/index = 3 | written per frame
+		int					m_firstObjectLocation;		// uniform uint firstObject of both vertex shaders
+		bool				m_compact;					// renderable.isCompact() => CompactVertex + VertexDecode per draw call
+		std::array<int, 4>	m_decodeLocations;			// uniform VertexDecode decode of both vertex shaders
+		std::vector<pje::engine::types::LSysPrimitive>	m_visiblePrimitives;	// copies: LSysPrimitives of the current LOD run inside of the view frustum
+		std::vector<uint32_t>							m_visibleInstances;		// instanced: indices into m_instances of all LOD runs inside of the view frustum
+		std::vector<pje::engine::types::InstanceRange>	m_visibleRanges;		// instanced: [run * sources + primitiveId] := part of m_visibleInstances
+		std::vector<pje::engine::types::ElementRange>	m_dirtyBoneRanges;		// copies: dirty ranges of m_bonePalette => updateBuffer(StorageBones)
+		pje::engine::types::CullStats					m_cullStats;
 
 		void setGlobalSettings();
-		void setShaderProgram(std::string shaderName, uint32_t& rawProgram);
+		void setShaderProgram(std::string vertexShaderName, std::string fragmentShaderName, uint32_t& rawProgram);
 		std::string loadShader(const std::string& filename);
+		void setVertexDecode(const pje::engine::types::VertexDecode& decode);
+		/* instanced: culls the instances of all runs => m_visibleInstances are uploaded once per frame */
+		void cullInstancesOf(const pje::engine::types::LSysObject& renderable, const std::vector<pje::engine::types::LodRun>& runs);
+		/* elements range of data (count * stride bytes) => buffer handle | returns true if handle was too small and got all count elements */
+		bool patchBuffer(uint32_t handle, GLenum usage, const void* data, size_t stride, size_t count, const pje::engine::types::ElementRange& range);
 	};
 }
\ No newline at end of file
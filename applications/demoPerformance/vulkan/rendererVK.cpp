@@ -5,7 +5,9 @@
 
 pje::renderer::RendererVK::RendererVK(const pje::engine::ArgsParser& parser, GLFWwindow* const window, const pje::engine::types::LSysObject& renderable) : 
 	m_context(), m_renderWidth(parser.m_width), m_renderHeight(parser.m_height), m_windowIconified(false), m_vsync(parser.m_vsync), 
-	m_anisotropyLevel(AnisotropyLevel::TWOx), m_msaaFactor(VkSampleCountFlagBits::VK_SAMPLE_COUNT_4_BIT), m_instanceCount(parser.m_amountOfObjects) {
+	m_anisotropyLevel(AnisotropyLevel::TWOx), m_msaaFactor(VkSampleCountFlagBits::VK_SAMPLE_COUNT_4_BIT), m_instanceCount(parser.m_amountOfObjects), 
+	m_instanced(renderable.isInstanced()), m_compact(renderable.isCompact()), m_boneFormat(static_cast<uint32_t>(renderable.getBoneFormat())), 
+	m_boneFormatEntry(), m_vertexSpecialization(), m_cullStats() {
 
 	std::cout << "[VK] \tVulkan Version: " << getApiVersion() << std::endl;
 
@@ -30,17 +32,20 @@ pje::renderer::RendererVK::RendererVK(const pje::engine::ArgsParser& parser, GLF
 	if (!requestExtension(RequestLevel::Device, "VK_KHR_swapchain"))
 		throw std::runtime_error("Choosen GPU does not support the required swapchain extension.");
 	setDeviceAndQueue(VkQueueFlagBits::VK_QUEUE_GRAPHICS_BIT | VkQueueFlagBits::VK_QUEUE_TRANSFER_BIT);
-	setShaderProgram("basic_vulkan");
-
-	/* 2) Declaration of shader code structure => modeled after "basic_vulkan" */
-	setDescriptorSet(
-		std::vector<DescriptorSetElementVK>{
-			{VkDescriptorType::VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT}, 
-			{VkDescriptorType::VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT}, 
-			{VkDescriptorType::VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT}, 
-			{VkDescriptorType::VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VkShaderStageFlagBits::VK_SHADER_STAGE_FRAGMENT_BIT}
-		}
-	);
+	setShaderProgram(m_instanced ? "instanced_vulkan" : "basic_vulkan", "basic_vulkan");
+
+	/* 2) Declaration of shader code structure => modeled after "basic_vulkan" | "instanced_vulkan" adds bindings 4 and 5 */
+	std::vector<DescriptorSetElementVK> shaderResources{
+		{VkDescriptorType::VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT}, 
+		{VkDescriptorType::VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT}, 
+		{VkDescriptorType::VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT}, 
+		{VkDescriptorType::VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VkShaderStageFlagBits::VK_SHADER_STAGE_FRAGMENT_BIT}
+	};
+	if (m_instanced) {
+		shaderResources.push_back({VkDescriptorType::VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT});
+		shaderResources.push_back({VkDescriptorType::VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT});
+	}
+	setDescriptorSet(shaderResources);
 	setTexSampler();
 	setRenderpass();
 	buildPipeline();
@@ -89,6 +94,8 @@ pje::renderer::RendererVK::~RendererVK() {
 	m_buffUniformMVP.~BufferVK();
 	m_buffStorageBones.~BufferVK();
 	m_buffStorageBoneRefs.~BufferVK();
+	m_buffStorageInstances.~BufferVK();
+	m_buffVisibleInstances.~BufferVK();
 	
 	m_texAlbedo.~ImageVK();
 	m_context.buffIndices.~BufferVK();
@@ -161,15 +168,11 @@ void pje::renderer::RendererVK::uploadRenderable(const pje::engine::types::LSysO
 		vkDestroyBuffer(m_context.device, m_context.buffIndices.buffer, nullptr);
 	}
 
-	/* 1) Vertices */
+	/* 1) Vertices | CompactVertex if quantized */
 	m_context.buffVertices.hostDevice	= m_context.device;
-	m_context.buffVertices.size			= static_cast<VkDeviceSize>(
-		(
-			renderable.m_objectPrimitives.back().m_meshes.back().m_vertices.size() +
-			renderable.m_objectPrimitives.back().m_meshes.back().m_offsetPriorMeshesVertices +
-			renderable.m_objectPrimitives.back().m_offsetPriorPrimitivesVertices
-		) * sizeof(pje::engine::types::Vertex)
-	);
+	m_context.buffVertices.size			= m_compact ?
+		static_cast<VkDeviceSize>(renderable.m_compactVertices.size() * sizeof(pje::engine::types::CompactVertex)) :
+		static_cast<VkDeviceSize>(renderable.m_vertices.size() * sizeof(pje::engine::types::Vertex));
 	m_context.buffVertices.buffer		= allocateBuffer(m_context.buffVertices.size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
 	VkMemoryRequirements memReqVertices;
 	vkGetBufferMemoryRequirements(m_context.device, m_context.buffVertices.buffer, &memReqVertices);
@@ -178,48 +181,32 @@ void pje::renderer::RendererVK::uploadRenderable(const pje::engine::types::LSysO
 
 	/* 2) Indices */
 	m_context.buffIndices.hostDevice	= m_context.device;
-	m_context.buffIndices.size			= static_cast<VkDeviceSize>(
-		(
-			renderable.m_objectPrimitives.back().m_meshes.back().m_indices.size() +
-			renderable.m_objectPrimitives.back().m_meshes.back().m_offsetPriorMeshesIndices +
-			renderable.m_objectPrimitives.back().m_offsetPriorPrimitivesIndices
-		) * sizeof(uint32_t)
-	);
+	m_context.buffIndices.size			= static_cast<VkDeviceSize>(renderable.m_indices.size() * sizeof(uint32_t));
 	m_context.buffIndices.buffer		= allocateBuffer(m_context.buffIndices.size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
 	VkMemoryRequirements memReqIndices;
 	vkGetBufferMemoryRequirements(m_context.device, m_context.buffIndices.buffer, &memReqIndices);
 	m_context.buffIndices.memory		= allocateMemory(memReqIndices, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 	vkBindBufferMemory(m_context.buffIndices.hostDevice, m_context.buffIndices.buffer, m_context.buffIndices.memory, 0);
 
-	/* 3) Uploading */
-	VkDeviceSize vByteOffset = 0;
-	VkDeviceSize vByteSize;
-	VkDeviceSize iByteOffset = 0;
-	VkDeviceSize iByteSize;
+	/* 3) Uploading => each arena via staging with 1 copy */
 	void* dstPtr;
 
-	for (const auto& primitive : renderable.m_objectPrimitives) {
-		for (const auto& mesh : primitive.m_meshes) {
-			vByteSize = sizeof(pje::engine::types::Vertex) * mesh.m_vertices.size();
-			iByteSize = sizeof(uint32_t) * mesh.m_indices.size();
-
-			/* Upload via staging each mesh individually */
-			prepareStaging(vByteSize);
-			vkMapMemory(m_context.buffStaging.hostDevice, m_context.buffStaging.memory, 0, VK_WHOLE_SIZE, 0, &dstPtr);
-			memcpy(dstPtr, mesh.m_vertices.data(), vByteSize);
-			vkUnmapMemory(m_context.buffStaging.hostDevice, m_context.buffStaging.memory);
-			copyStagedBuffer(m_context.buffVertices.buffer, vByteOffset, vByteSize);
-
-			prepareStaging(iByteSize);
-			vkMapMemory(m_context.buffStaging.hostDevice, m_context.buffStaging.memory, 0, VK_WHOLE_SIZE, 0, &dstPtr);
-			memcpy(dstPtr, mesh.m_indices.data(), iByteSize);
-			vkUnmapMemory(m_context.buffStaging.hostDevice, m_context.buffStaging.memory);
-			copyStagedBuffer(m_context.buffIndices.buffer, iByteOffset, iByteSize);
-
-			vByteOffset += vByteSize;
-			iByteOffset += iByteSize;
-		}
-	}
+	prepareStaging(m_context.buffVertices.size);
+	vkMapMemory(m_context.buffStaging.hostDevice, m_context.buffStaging.memory, 0, VK_WHOLE_SIZE, 0, &dstPtr);
+	memcpy(
+		dstPtr, 
+		m_compact ? static_cast<const void*>(renderable.m_compactVertices.data()) : static_cast<const void*>(renderable.m_vertices.data()), 
+		m_context.buffVertices.size
+	);
+	vkUnmapMemory(m_context.buffStaging.hostDevice, m_context.buffStaging.memory);
+	copyStagedBuffer(m_context.buffVertices.buffer, 0, m_context.buffVertices.size);
+
+	prepareStaging(m_context.buffIndices.size);
+	vkMapMemory(m_context.buffStaging.hostDevice, m_context.buffStaging.memory, 0, VK_WHOLE_SIZE, 0, &dstPtr);
+	memcpy(dstPtr, renderable.m_indices.data(), m_context.buffIndices.size);
+	vkUnmapMemory(m_context.buffStaging.hostDevice, m_context.buffStaging.memory);
+	copyStagedBuffer(m_context.buffIndices.buffer, 0, m_context.buffIndices.size);
+
 	std::cout << "[VK] \tUploading renderable --- DONE" << std::endl;
 }
 
@@ -347,7 +334,7 @@ void pje::renderer::RendererVK::uploadBuffer(const pje::engine::types::LSysObjec
 		break;
 	case BufferType::StorageBones:
 		m_VarRaw.hostDevice = m_context.device;
-		m_VarRaw.size		= sizeof(glm::mat4) * renderable.m_bones.size();
+		m_VarRaw.size		= renderable.getBoneStride() * renderable.m_bonePalette.size();
 		m_VarRaw.buffer		= allocateBuffer(m_VarRaw.size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
 
 		vkGetBufferMemoryRequirements(m_context.device, m_VarRaw.buffer, &memReq);
@@ -356,7 +343,23 @@ void pje::renderer::RendererVK::uploadBuffer(const pje::engine::types::LSysObjec
 
 		prepareStaging(m_VarRaw.size);
 		vkMapMemory(m_context.buffStaging.hostDevice, m_context.buffStaging.memory, 0, VK_WHOLE_SIZE, 0, &dstPtr);
-		memcpy(dstPtr, renderable.getBoneMatrices().data(), m_VarRaw.size);
+		memcpy(dstPtr, renderable.getBoneData(), m_VarRaw.size);
+		vkUnmapMemory(m_context.buffStaging.hostDevice, m_context.buffStaging.memory);
+		copyStagedBuffer(m_VarRaw.buffer, 0, m_VarRaw.size);
+
+		break;
+	case BufferType::StorageInstances:
+		m_VarRaw.hostDevice = m_context.device;
+		m_VarRaw.size		= sizeof(pje::engine::types::PrimitiveInstance) * renderable.m_instances.size();
+		m_VarRaw.buffer		= allocateBuffer(m_VarRaw.size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+		vkGetBufferMemoryRequirements(m_context.device, m_VarRaw.buffer, &memReq);
+		m_VarRaw.memory		= allocateMemory(memReq, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+		vkBindBufferMemory(m_VarRaw.hostDevice, m_VarRaw.buffer, m_VarRaw.memory, 0);
+
+		prepareStaging(m_VarRaw.size);
+		vkMapMemory(m_context.buffStaging.hostDevice, m_context.buffStaging.memory, 0, VK_WHOLE_SIZE, 0, &dstPtr);
+		memcpy(dstPtr, renderable.m_instances.data(), m_VarRaw.size);
 		vkUnmapMemory(m_context.buffStaging.hostDevice, m_context.buffStaging.memory);
 		copyStagedBuffer(m_VarRaw.buffer, 0, m_VarRaw.size);
 
@@ -466,9 +469,29 @@ void pje::renderer::RendererVK::updateBuffer(const pje::engine::types::LSysObjec
 
 		break;
 	case BufferType::StorageBones:
+		/* only dirty ranges of m_bonePalette (packed in renderable.getBoneFormat()) => same offsets inside of staging buffer and storage buffer */
+		renderable.getDirtyBoneRanges(m_dirtyBoneRanges);
+		if (m_dirtyBoneRanges.empty())
+			break;
+
+		m_boneCopyRegions.clear();
+		prepareStaging(m_Var.size);
+		vkMapMemory(m_context.buffStaging.hostDevice, m_context.buffStaging.memory, 0, VK_WHOLE_SIZE, 0, &dstPtr);
+		for (const auto& range : m_dirtyBoneRanges) {
+			const VkDeviceSize offset = renderable.getBoneStride() * range.first;
+			const VkDeviceSize size = renderable.getBoneStride() * range.count;
+
+			memcpy(static_cast<char*>(dstPtr) + offset, static_cast<const char*>(renderable.getBoneData()) + offset, size);
+			m_boneCopyRegions.push_back(VkBufferCopy{ offset, offset, size });
+		}
+		vkUnmapMemory(m_context.buffStaging.hostDevice, m_context.buffStaging.memory);
+		copyStagedBuffer(m_Var.buffer, m_boneCopyRegions);
+
+		break;
+	case BufferType::StorageInstances:
 		prepareStaging(m_Var.size);
 		vkMapMemory(m_context.buffStaging.hostDevice, m_context.buffStaging.memory, 0, VK_WHOLE_SIZE, 0, &dstPtr);
-		memcpy(dstPtr, renderable.getBoneMatrices().data(), m_Var.size);
+		memcpy(dstPtr, renderable.m_instances.data(), m_Var.size);
 		vkUnmapMemory(m_context.buffStaging.hostDevice, m_context.buffStaging.memory);
 		copyStagedBuffer(m_Var.buffer, 0, m_Var.size);
 
@@ -476,6 +499,35 @@ void pje::renderer::RendererVK::updateBuffer(const pje::engine::types::LSysObjec
 	}
 }
 
+void pje::renderer::RendererVK::updateRenderable(const pje::engine::types::LSysObject& renderable, const pje::engine::types::LSysObjectPatch& patch) {
+	/* frames in flight may still read the patched buffers */
+	vkDeviceWaitIdle(m_context.device);
+
+	/* 1) Vertices | CompactVertex if quantized (same element count) => bound per recorded command buffer */
+	patchBuffer(
+		m_context.buffVertices, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, 
+		m_compact ? static_cast<const void*>(renderable.m_compactVertices.data()) : static_cast<const void*>(renderable.m_vertices.data()), 
+		m_compact ? sizeof(pje::engine::types::CompactVertex) : sizeof(pje::engine::types::Vertex), renderable.m_vertices.size(), patch.vertices
+	);
+
+	/* 2) Indices => bound per recorded command buffer */
+	patchBuffer(m_context.buffIndices, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, renderable.m_indices.data(), sizeof(uint32_t), renderable.m_indices.size(), patch.indices);
+
+	/* 3) Storage buffers => descriptor set is written again if a buffer was replaced | contents of m_bonePalette follow via updateBuffer(StorageBones) (all entries dirty) */
+	if (patchBuffer(m_buffStorageBoneRefs, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, renderable.m_boneRefs.data(), sizeof(pje::engine::types::BoneRef), renderable.m_boneRefs.size(), patch.boneRefs))
+		bindToShader(m_buffStorageBoneRefs, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+	if (patchBuffer(m_buffStorageBones, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, renderable.getBoneData(), renderable.getBoneStride(), renderable.m_bonePalette.size(), pje::engine::types::ElementRange{ 0, 0 }))
+		bindToShader(m_buffStorageBones, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+	if (m_instanced && patchBuffer(m_buffStorageInstances, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, renderable.m_instances.data(), sizeof(pje::engine::types::PrimitiveInstance), renderable.m_instances.size(), patch.instances))
+		bindToShader(m_buffStorageInstances, 4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+
+	std::cout << "[VK] \tPatching renderable --- DONE" << std::endl;
+}
+
+pje::engine::types::CullStats pje::renderer::RendererVK::getCullStats() const {
+	return m_cullStats;
+}
+
 /* ### Private methods ### */
 
 std::string pje::renderer::RendererVK::getApiVersion() {
@@ -781,29 +833,40 @@ void pje::renderer::RendererVK::setShaderModule(VkShaderModule& shaderModule, co
 		throw std::runtime_error("Failed to create shader module.");
 }
 
-void pje::renderer::RendererVK::setShaderProgram(std::string shaderName) {
+void pje::renderer::RendererVK::setShaderProgram(std::string vertexShaderName, std::string fragmentShaderName) {
 	if (!m_context.shaderProgram.empty())
 		m_context.shaderProgram.clear();
 
-	auto vertexShader	= loadShader("assets/shaders/" + shaderName + ".vert.spv");
-	auto fragmentShader = loadShader("assets/shaders/" + shaderName + ".frag.spv");
+	auto vertexShader	= loadShader("assets/shaders/" + vertexShaderName + ".vert.spv");
+	auto fragmentShader = loadShader("assets/shaders/" + fragmentShaderName + ".frag.spv");
 
 	setShaderModule(m_context.vertexModule, vertexShader);
 	setShaderModule(m_context.fragmentModule, fragmentShader);
 
+	/* constant_id 0 of both vertex shaders := BoneFormat of the renderable => branches of other formats are removed by the driver */
+	m_boneFormatEntry.constantID	= 0;
+	m_boneFormatEntry.offset		= 0;
+	m_boneFormatEntry.size			= sizeof(uint32_t);
+
+	m_vertexSpecialization.mapEntryCount	= 1;
+	m_vertexSpecialization.pMapEntries		= &m_boneFormatEntry;
+	m_vertexSpecialization.dataSize			= sizeof(uint32_t);
+	m_vertexSpecialization.pData			= &m_boneFormat;
+
 	VkPipelineShaderStageCreateInfo shaderStageInfo;
 	shaderStageInfo.sType				= VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
 	shaderStageInfo.pNext				= nullptr;
 	shaderStageInfo.flags				= 0;
 	shaderStageInfo.pName				= "main";
-	shaderStageInfo.pSpecializationInfo = nullptr;
 
-	shaderStageInfo.stage	= VK_SHADER_STAGE_VERTEX_BIT;
-	shaderStageInfo.module	= m_context.vertexModule;
+	shaderStageInfo.stage				= VK_SHADER_STAGE_VERTEX_BIT;
+	shaderStageInfo.module				= m_context.vertexModule;
+	shaderStageInfo.pSpecializationInfo = &m_vertexSpecialization;
 	m_context.shaderProgram.push_back(shaderStageInfo);
 
-	shaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-	shaderStageInfo.module = m_context.fragmentModule;
+	shaderStageInfo.stage				= VK_SHADER_STAGE_FRAGMENT_BIT;
+	shaderStageInfo.module				= m_context.fragmentModule;
+	shaderStageInfo.pSpecializationInfo = nullptr;
 	m_context.shaderProgram.push_back(shaderStageInfo);
 
 	std::cout << "[VK] \tShader program with " << m_context.shaderProgram.size() << " shaders was set." << std::endl;
@@ -1267,8 +1330,8 @@ void pje::renderer::RendererVK::buildPipeline() {
 	inputAssemblyInfo.topology					= VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
 	inputAssemblyInfo.primitiveRestartEnable	= VK_FALSE;
 
-	auto vertexBindingDesc = pje::engine::types::Vertex::getVulkanBindingDesc();
-	auto vertexAttribsDesc = pje::engine::types::Vertex::getVulkanAttribDesc();
+	auto vertexBindingDesc = m_compact ? pje::engine::types::CompactVertex::getVulkanBindingDesc() : pje::engine::types::Vertex::getVulkanBindingDesc();
+	auto vertexAttribsDesc = m_compact ? pje::engine::types::CompactVertex::getVulkanAttribDesc() : pje::engine::types::Vertex::getVulkanAttribDesc();
 
 	/* Holds vertex attributes */
 	VkPipelineVertexInputStateCreateInfo vertexInputInfo;
@@ -1337,6 +1400,12 @@ void pje::renderer::RendererVK::buildPipeline() {
 	depthStencilStateInfo.minDepthBounds	= 0.0f;
 	depthStencilStateInfo.maxDepthBounds	= 1.0f;
 
+	/* PushConstantRange: VertexDecode of both vertex shaders + InstanceRange{first, count} of "instanced_vulkan" */
+	VkPushConstantRange pushConstantInfo;
+	pushConstantInfo.stageFlags	= VK_SHADER_STAGE_VERTEX_BIT;
+	pushConstantInfo.offset		= 0;
+	pushConstantInfo.size		= static_cast<uint32_t>(sizeof(pje::engine::types::VertexDecode) + (m_instanced ? sizeof(pje::engine::types::InstanceRange) : 0));
+
 	/* PipelineLayout: Declares variables of programmable shaders */
 	VkPipelineLayoutCreateInfo pipelineLayoutInfo;
 	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
@@ -1344,8 +1413,8 @@ void pje::renderer::RendererVK::buildPipeline() {
 	pipelineLayoutInfo.flags = 0;
 	pipelineLayoutInfo.setLayoutCount = 1;
 	pipelineLayoutInfo.pSetLayouts = &m_context.descriptorSetLayout;
-	pipelineLayoutInfo.pushConstantRangeCount = 0;
-	pipelineLayoutInfo.pPushConstantRanges = nullptr;
+	pipelineLayoutInfo.pushConstantRangeCount = 1;
+	pipelineLayoutInfo.pPushConstantRanges = &pushConstantInfo;
 	vkCreatePipelineLayout(m_context.device, &pipelineLayoutInfo, nullptr, &m_context.pipelineLayout);
 
 	/* PipelineInfo: Defines workflow for a subpass of some renderpass */
@@ -1553,7 +1622,54 @@ void pje::renderer::RendererVK::prepareStaging(VkDeviceSize requiredSize) {
 	}
 }
 
+bool pje::renderer::RendererVK::patchBuffer(BufferVK& buffer, VkBufferUsageFlags usage, const void* data, VkDeviceSize stride, size_t count, const pje::engine::types::ElementRange& range) {
+	const VkDeviceSize requiredSize = stride * count;
+	if (requiredSize == 0)
+		return false;
+
+	/* too small => replaced by a buffer of requiredSize that receives every element */
+	const bool grown = buffer.buffer == VK_NULL_HANDLE || buffer.size < requiredSize;
+	if (grown) {
+		if (buffer.buffer != VK_NULL_HANDLE) {
+			vkFreeMemory(buffer.hostDevice, buffer.memory, nullptr);
+			vkDestroyBuffer(buffer.hostDevice, buffer.buffer, nullptr);
+		}
+
+		buffer.hostDevice	= m_context.device;
+		buffer.size			= requiredSize;
+		buffer.buffer		= allocateBuffer(buffer.size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage);
+
+		VkMemoryRequirements memReq;
+		vkGetBufferMemoryRequirements(m_context.device, buffer.buffer, &memReq);
+		buffer.memory		= allocateMemory(memReq, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+		vkBindBufferMemory(buffer.hostDevice, buffer.buffer, buffer.memory, 0);
+	}
+
+	const VkDeviceSize offset	= grown ? 0 : stride * range.first;
+	const VkDeviceSize size		= grown ? requiredSize : stride * range.count;
+	if (size == 0)
+		return grown;
+
+	/* same offset inside of buffer => 1 staged VkBufferCopy */
+	void* dstPtr;
+	prepareStaging(size);
+	vkMapMemory(m_context.buffStaging.hostDevice, m_context.buffStaging.memory, 0, VK_WHOLE_SIZE, 0, &dstPtr);
+	memcpy(dstPtr, static_cast<const char*>(data) + offset, size);
+	vkUnmapMemory(m_context.buffStaging.hostDevice, m_context.buffStaging.memory);
+	copyStagedBuffer(buffer.buffer, offset, size);
+
+	return grown;
+}
+
 void pje::renderer::RendererVK::copyStagedBuffer(VkBuffer dst, const VkDeviceSize offsetInDst, const VkDeviceSize dataInfo) {
+	VkBufferCopy copyRegion;
+	copyRegion.srcOffset	= 0;
+	copyRegion.dstOffset	= offsetInDst;
+	copyRegion.size			= dataInfo;
+	copyStagedBuffer(dst, std::vector<VkBufferCopy>{ copyRegion });
+}
+
+void pje::renderer::RendererVK::copyStagedBuffer(VkBuffer dst, const std::vector<VkBufferCopy>& regions) {
 	if (m_context.cbStaging == VK_NULL_HANDLE) {
 		VkCommandBufferAllocateInfo cbAllocateInfo;
 		cbAllocateInfo.sType				= VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -1574,12 +1690,8 @@ void pje::renderer::RendererVK::copyStagedBuffer(VkBuffer dst, const VkDeviceSiz
 	cbBeginInfo.pInheritanceInfo	= nullptr;
 	vkBeginCommandBuffer(m_context.cbStaging, &cbBeginInfo);
 
-	/* Copying */
-	VkBufferCopy copyRegion;
-	copyRegion.srcOffset	= 0;
-	copyRegion.dstOffset	= offsetInDst;
-	copyRegion.size			= dataInfo;
-	vkCmdCopyBuffer(m_context.cbStaging, m_context.buffStaging.buffer, dst, 1, &copyRegion);
+	/* Copying => all regions with 1 submit */
+	vkCmdCopyBuffer(m_context.cbStaging, m_context.buffStaging.buffer, dst, static_cast<uint32_t>(regions.size()), regions.data());
 
 	vkEndCommandBuffer(m_context.cbStaging);
 
@@ -1875,7 +1987,51 @@ void pje::renderer::RendererVK::generateMipmaps(ImageVK& uploadedTexture, unsign
 	vkResetFences(uploadedTexture.hostDevice, 1, &m_context.fenceSetupTask);
 }
 
+void pje::renderer::RendererVK::cullInstancesOf(const pje::engine::types::LSysObject& renderable, const std::vector<pje::engine::types::LodRun>& runs) {
+	m_visibleInstances.clear();
+	m_visibleRanges.clear();
+	for (const auto& run : runs) {
+		const auto stats = renderable.cullInstances(run, m_visibleInstances, m_visibleRanges);
+		m_cullStats.visible	+= stats.visible;
+		m_cullStats.culled	+= stats.culled;
+	}
+
+	const VkDeviceSize requiredSize = sizeof(uint32_t) * m_visibleInstances.size();
+	if (requiredSize == 0)
+		return;
+
+	/* too small => replaced before the descriptor set is bound (prior frame has finished => fenceImgRendered) | 1 LOD run needs every instance at most */
+	if (m_buffVisibleInstances.buffer == VK_NULL_HANDLE || m_buffVisibleInstances.size < requiredSize) {
+		if (m_buffVisibleInstances.buffer != VK_NULL_HANDLE) {
+			vkFreeMemory(m_buffVisibleInstances.hostDevice, m_buffVisibleInstances.memory, nullptr);
+			vkDestroyBuffer(m_buffVisibleInstances.hostDevice, m_buffVisibleInstances.buffer, nullptr);
+		}
+
+		m_buffVisibleInstances.hostDevice	= m_context.device;
+		m_buffVisibleInstances.size			= std::max(requiredSize, static_cast<VkDeviceSize>(sizeof(uint32_t) * renderable.m_instances.size()));
+		m_buffVisibleInstances.buffer		= allocateBuffer(m_buffVisibleInstances.size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+		VkMemoryRequirements memReq;
+		vkGetBufferMemoryRequirements(m_context.device, m_buffVisibleInstances.buffer, &memReq);
+		m_buffVisibleInstances.memory		= allocateMemory(memReq, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+		vkBindBufferMemory(m_buffVisibleInstances.hostDevice, m_buffVisibleInstances.buffer, m_buffVisibleInstances.memory, 0);
+
+		bindToShader(m_buffVisibleInstances, 5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+	}
+
+	void* dstPtr;
+	vkMapMemory(m_buffVisibleInstances.hostDevice, m_buffVisibleInstances.memory, 0, VK_WHOLE_SIZE, 0, &dstPtr);
+	memcpy(dstPtr, m_visibleInstances.data(), requiredSize);
+	vkUnmapMemory(m_buffVisibleInstances.hostDevice, m_buffVisibleInstances.memory);
+}
+
 void pje::renderer::RendererVK::recordCbRenderingFor(const pje::engine::types::LSysObject& renderable, uint32_t imgIndex) {
+	/* Culling => instanced: visible instances of all LOD runs are written before the descriptor set is bound */
+	const auto runs = renderable.selectLods(m_instanceCount);
+	m_cullStats = {};
+	if (m_instanced)
+		cullInstancesOf(renderable, runs);
+
 	VkCommandBufferBeginInfo cbBeginInfo;
 	cbBeginInfo.sType				= VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 	cbBeginInfo.pNext				= nullptr;
@@ -1911,17 +2067,69 @@ void pje::renderer::RendererVK::recordCbRenderingFor(const pje::engine::types::L
 	vkCmdBindVertexBuffers(m_context.cbsRendering[imgIndex], 0, 1, &m_context.buffVertices.buffer, offsets);
 	vkCmdBindIndexBuffer(m_context.cbsRendering[imgIndex], m_context.buffIndices.buffer, 0, VK_INDEX_TYPE_UINT32);
 
-	/* Drawing all meshes of each primitive */
-	for (const auto& primitive : renderable.m_objectPrimitives) {
-		for (const auto& mesh : primitive.m_meshes) {
-			vkCmdDrawIndexed(
-				m_context.cbsRendering[imgIndex],
-				mesh.m_indices.size(),
-				m_instanceCount,
-				primitive.m_offsetPriorPrimitivesIndices + mesh.m_offsetPriorMeshesIndices,		// baseIndex
-				primitive.m_offsetPriorPrimitivesVertices + mesh.m_offsetPriorMeshesVertices,	// <actualIndexToVBO> = thisOffsetSum + baseIndex
-				0
-			);
+	/* Vertex => decode is pushed once | CompactVertex => pushed per draw call */
+	static const pje::engine::types::VertexDecode uncompressed{};
+	if (!m_compact) {
+		vkCmdPushConstants(
+			m_context.cbsRendering[imgIndex], m_context.pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(pje::engine::types::VertexDecode), &uncompressed
+		);
+	}
+
+	/* Drawing => objects of the same LOD share their draw calls | firstInstance := first object of each run | branches (instanced: instances) outside of the view frustum are skipped */
+	for (size_t r = 0; r < runs.size(); r++) {
+		const auto& run = runs[r];
+		if (!m_instanced) {
+			const auto stats = renderable.cullPrimitives(run, m_visiblePrimitives);
+			m_cullStats.visible	+= stats.visible;
+			m_cullStats.culled	+= stats.culled;
+			if (stats.visible == 0)
+				continue;
+		}
+
+		if (m_instanced) {
+			/* Drawing each source primitive once for all of its visible instances */
+			for (size_t id = 0; id < renderable.m_objectPrimitives.size(); id++) {
+				const auto& primitive	= renderable.m_objectPrimitives[id];
+				const auto& range		= m_visibleRanges[r * renderable.m_objectPrimitives.size() + id];
+				if (range.count == 0)
+					continue;
+
+				if (m_compact) {
+					vkCmdPushConstants(
+						m_context.cbsRendering[imgIndex], m_context.pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(pje::engine::types::VertexDecode), &primitive.decode
+					);
+				}
+				vkCmdPushConstants(
+					m_context.cbsRendering[imgIndex], m_context.pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 
+					sizeof(pje::engine::types::VertexDecode), sizeof(pje::engine::types::InstanceRange), &range
+				);
+				vkCmdDrawIndexed(
+					m_context.cbsRendering[imgIndex],
+					primitive.indexCount,
+					range.count * run.objectCount,
+					primitive.firstIndex,				// baseIndex
+					primitive.firstVertex,				// <actualIndexToVBO> = firstVertex + index
+					range.count * run.firstObject		// gl_InstanceIndex / range.count := object
+				);
+			}
+		}
+		else {
+			/* Drawing each visible primitive => its meshes share 1 index range */
+			for (const auto& primitive : m_visiblePrimitives) {
+				if (m_compact) {
+					vkCmdPushConstants(
+						m_context.cbsRendering[imgIndex], m_context.pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(pje::engine::types::VertexDecode), &primitive.decode
+					);
+				}
+				vkCmdDrawIndexed(
+					m_context.cbsRendering[imgIndex],
+					primitive.indexCount,
+					run.objectCount,
+					primitive.firstIndex,				// baseIndex
+					primitive.firstVertex,				// <actualIndexToVBO> = firstVertex + index
+					run.firstObject						// gl_InstanceIndex := object
+				);
+			}
 		}
 	}
 
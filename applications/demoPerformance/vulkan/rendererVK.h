@@ -123,12 +123,13 @@ namespace pje::renderer {
 	class RendererVK final {
 	public:
 		enum class TextureType	{ Albedo };
-		enum class BufferType	{ UniformMVP, StorageBoneRefs, StorageBones };
+		enum class BufferType	{ UniformMVP, StorageBoneRefs, StorageBones, StorageInstances };
 
 		ImageVK		m_texAlbedo;
 		BufferVK	m_buffUniformMVP;
 		BufferVK	m_buffStorageBoneRefs;
 		BufferVK	m_buffStorageBones;
+		BufferVK	m_buffStorageInstances;		// instanced LSysObject only => binding 4
 
 		RendererVK() = delete;
 		RendererVK(const pje::engine::ArgsParser& parser, GLFWwindow* const window, const pje::engine::types::LSysObject& renderable);
@@ -146,6 +147,11 @@ namespace pje::renderer {
 		void renderIn(GLFWwindow* window, const pje::engine::types::LSysObject& renderable);
 		/* 4/4: Updating shader resources */
 		void updateBuffer(const pje::engine::types::LSysObject& renderable, BufferVK& m_Var, BufferType type);
+		/* ranges of patch (PlantTurtle::rebuildLSysObject()) => staged VkBufferCopy | buffers that became too small are allocated (and bound) again */
+		void updateRenderable(const pje::engine::types::LSysObject& renderable, const pje::engine::types::LSysObjectPatch& patch);
+
+		/* frustum culling of the latest renderIn() */
+		pje::engine::types::CullStats getCullStats() const;
 
 	private:
 		enum class RequestLevel		{ Instance, Device };
@@ -159,6 +165,18 @@ namespace pje::renderer {
 		AnisotropyLevel			m_anisotropyLevel;
 		VkSampleCountFlagBits	m_msaaFactor;
 		uint8_t					m_instanceCount;
+		bool					m_instanced;		// renderable.isInstanced() => "instanced_vulkan" vertex shader + push constant InstanceRange
+		bool					m_compact;			// renderable.isCompact() => CompactVertex + push constant VertexDecode per draw call
+		uint32_t				m_boneFormat;		// renderable.getBoneFormat() => specialization constant boneFormat of both vertex shaders
+		VkSpecializationMapEntry	m_boneFormatEntry;		// constant_id 0 => m_boneFormat
+		VkSpecializationInfo		m_vertexSpecialization;	// referenced by the vertex stage of m_context.shaderProgram until buildPipeline()
+		std::vector<pje::engine::types::LSysPrimitive>	m_visiblePrimitives;	// copies: LSysPrimitives of the current LOD run inside of the view frustum
+		std::vector<uint32_t>							m_visibleInstances;		// instanced: indices into m_instances of all LOD runs inside of the view frustum
+		std::vector<pje::engine::types::InstanceRange>	m_visibleRanges;		// instanced: [run * sources + primitiveId] := part of m_visibleInstances
+		BufferVK										m_buffVisibleInstances;	// instanced: m_visibleInstances => binding 5 | host visible, written per frame
+		std::vector<pje::engine::types::ElementRange>	m_dirtyBoneRanges;		// copies: dirty ranges of m_bonePalette => updateBuffer(StorageBones)
+		std::vector<VkBufferCopy>						m_boneCopyRegions;
+		pje::engine::types::CullStats					m_cullStats;
 
 		std::string getApiVersion();
 		void setInstance();
@@ -172,7 +190,7 @@ namespace pje::renderer {
 		void setSurfaceFormatForPhysicalDevice(VkSurfaceFormatKHR format);
 		void setDeviceAndQueue(VkQueueFlags requiredQueueAttributes);
 		void setShaderModule(VkShaderModule& shaderModule, const std::vector<char>& shaderCode);
-		void setShaderProgram(std::string shaderName);
+		void setShaderProgram(std::string vertexShaderName, std::string fragmentShaderName);
 		void setDescriptorSet(const std::vector<DescriptorSetElementVK>& elements);
 		void setTexSampler();
 		void setRenderpass();
@@ -191,9 +209,14 @@ namespace pje::renderer {
 		VkDeviceMemory allocateMemory(VkMemoryRequirements memReq, VkMemoryPropertyFlags flagMask);
 		VkBuffer allocateBuffer(VkDeviceSize requiredSize, VkBufferUsageFlags usage);
 		void prepareStaging(VkDeviceSize requiredSize);
+		/* elements range of data (count * stride bytes) => device local buffer | returns true if buffer was too small and got all count elements */
+		bool patchBuffer(BufferVK& buffer, VkBufferUsageFlags usage, const void* data, VkDeviceSize stride, size_t count, const pje::engine::types::ElementRange& range);
 		void copyStagedBuffer(VkBuffer dst, const VkDeviceSize offsetInDst, const VkDeviceSize dataInfo);
+		void copyStagedBuffer(VkBuffer dst, const std::vector<VkBufferCopy>& regions);
 		void copyStagedBuffer(VkImage dst, const pje::engine::types::Texture texInfo);
 		void generateMipmaps(ImageVK& uploadedTexture, unsigned int baseTexWidth, unsigned int baseTexHeight);
+		/* instanced: culls the instances of all runs => m_visibleInstances are written before recording (a grown buffer is bound again) */
+		void cullInstancesOf(const pje::engine::types::LSysObject& renderable, const std::vector<pje::engine::types::LodRun>& runs);
 		void recordCbRenderingFor(const pje::engine::types::LSysObject& renderable, uint32_t imgIndex);
 	};
 }
\ No newline at end of file